@@ -0,0 +1,122 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Minimal micro-benchmark harness, no dependencies
+// Each benchmark is warmed up, then timed in samples of a calibrated batch of calls so timer overhead
+// stays well below the measurement, and reported as per-call statistics over the samples
+namespace MicroBench {
+    struct Options {
+        double warmupMs = 100.0;
+        double sampleMs = 5.0;
+        int samples = 30;
+    };
+
+    struct Result {
+        std::string name;
+        size_t batch = 0;
+        double minNs = 0.0;
+        double medianNs = 0.0;
+        double meanNs = 0.0;
+        double stddevNs = 0.0;
+        double p90Ns = 0.0;
+    };
+
+    // Keeps the compiler from discarding a computed value
+    template <typename T>
+    inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    template <typename Body>
+    double timeBatch(Body& body, size_t batch) {
+        const auto start = Clock::now();
+        for (size_t i = 0; i < batch; i++) {
+            body();
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    template <typename Body>
+    Result run(const std::string& name, Body body, const Options& options = Options()) {
+        // Double the batch until one takes a sample's worth of time, then keep warming up
+        constexpr size_t maxBatch = size_t(1) << 30;
+        size_t batch = 1;
+        double elapsedNs = timeBatch(body, batch);
+        double warmedNs = elapsedNs;
+        while (elapsedNs < options.sampleMs * 1e6 && batch < maxBatch) {
+            batch *= 2;
+            elapsedNs = timeBatch(body, batch);
+            warmedNs += elapsedNs;
+        }
+        while (warmedNs < options.warmupMs * 1e6) {
+            warmedNs += timeBatch(body, batch);
+        }
+
+        std::vector<double> perCall(static_cast<size_t>(std::max(options.samples, 1)));
+        for (double& sample : perCall) {
+            sample = timeBatch(body, batch) / static_cast<double>(batch);
+        }
+        std::sort(perCall.begin(), perCall.end());
+
+        Result result;
+        result.name = name;
+        result.batch = batch;
+        result.minNs = perCall.front();
+        result.medianNs = perCall[perCall.size() / 2];
+        result.p90Ns = perCall[std::min(perCall.size() - 1, perCall.size() * 9 / 10)];
+        double sum = 0.0;
+        for (const double sample : perCall) {
+            sum += sample;
+        }
+        result.meanNs = sum / perCall.size();
+        double variance = 0.0;
+        for (const double sample : perCall) {
+            variance += (sample - result.meanNs) * (sample - result.meanNs);
+        }
+        result.stddevNs = std::sqrt(variance / perCall.size());
+        return result;
+    }
+
+    inline void printHeader(std::ostream& os) {
+        os << std::left << std::setw(44) << "benchmark" << std::right
+            << std::setw(12) << "median ns" << std::setw(12) << "mean ns" << std::setw(10) << "stddev"
+            << std::setw(12) << "min ns" << std::setw(12) << "p90 ns" << std::setw(12) << "batch" << '\n';
+    }
+
+    inline void print(std::ostream& os, const Result& r) {
+        os << std::left << std::setw(44) << r.name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(12) << r.medianNs << std::setw(12) << r.meanNs
+            << std::setw(9) << (r.meanNs > 0.0 ? r.stddevNs / r.meanNs * 100.0 : 0.0) << '%'
+            << std::setw(12) << r.minNs << std::setw(12) << r.p90Ns << std::setw(12) << r.batch << '\n';
+    }
+
+    inline void printJson(std::ostream& os, const std::vector<Result>& results) {
+        os << std::fixed << std::setprecision(3) << "{\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& r = results[i];
+            os << "  \"" << r.name << "\": { \"median_ns\": " << r.medianNs << ", \"mean_ns\": " << r.meanNs
+                << ", \"stddev_ns\": " << r.stddevNs << ", \"min_ns\": " << r.minNs << ", \"p90_ns\": " << r.p90Ns
+                << ", \"batch\": " << r.batch << " }" << (i + 1 < results.size() ? "," : "") << '\n';
+        }
+        os << "}\n";
+    }
+}
+
+#endif
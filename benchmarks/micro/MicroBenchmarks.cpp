@@ -0,0 +1,101 @@
+// Micro-benchmarks for engine hot paths, built by `make microbench`
+// Run from benchmarks/stress so the engine finds a resources folder:
+//   game_engine_microbench [name filter] [--samples N] [--json]
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "MicroBench.h"
+#include "core/Engine.h"
+
+namespace {
+    // Small config-like document for the Datadoc getters
+    const char* datadocJson = R"({
+        "game_title": "stress", "x_resolution": 640, "y_resolution": 360, "zoom_factor": 1.5,
+        "vsync": true, "initial_scene": "actor_find", "clear_color_r": 12, "cam_offset_x": 0.25
+    })";
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    bool json = false;
+    MicroBench::Options options;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        }
+        else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            options.samples = std::max(std::atoi(argv[++i]), 1);
+        }
+        else {
+            filter = argv[i];
+        }
+    }
+
+    // A headless engine on the actor_find stress scene: 10k "target" actors once it has updated twice
+    SDL_setenv(SDL_HINT_VIDEODRIVER, "dummy", 1);
+    SDL_setenv(SDL_HINT_AUDIODRIVER, "dummy", 1);
+    SDL_Init(SDL_INIT_EVERYTHING);
+    LaunchOptions launchOptions;
+    launchOptions.headless = true;
+    // The engine's headless report would land after the --json document
+    launchOptions.frameReport = false;
+    launchOptions.scene = "actor_find";
+    Engine engine(launchOptions);
+    ActorsGuild::update();
+    ActorsGuild::update();
+
+    rapidjson::Document document;
+    document.Parse(datadocJson);
+    Datadoc datadoc(document);
+
+    Input::addInputBinding("jump", "keyboard", "space");
+    Input::addInputBinding("fire", "mouse_button", "left");
+    Actor* target = ActorsGuild::getActorByName("target").cast<Actor*>();
+    int queued = 0;
+
+    std::vector<MicroBench::Result> results;
+    const auto bench = [&](const std::string& name, auto body) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) {
+            return;
+        }
+        results.push_back(MicroBench::run(name, body, options));
+        if (!json) {
+            MicroBench::print(std::cout, results.back());
+        }
+    };
+    if (!json) {
+        MicroBench::printHeader(std::cout);
+    }
+
+    bench("Datadoc::getInt", [&] { MicroBench::doNotOptimize(datadoc.getInt("x_resolution", 0)); });
+    bench("Datadoc::getFloat", [&] { MicroBench::doNotOptimize(datadoc.getFloat("zoom_factor", 1.0f)); });
+    bench("Datadoc::getBool", [&] { MicroBench::doNotOptimize(datadoc.getBool("vsync", false)); });
+    bench("Datadoc::getString", [&] { MicroBench::doNotOptimize(datadoc.getString("game_title", "")); });
+    bench("Datadoc::getInt (missing key)", [&] { MicroBench::doNotOptimize(datadoc.getInt("missing", 0)); });
+
+    bench("Input::getAction", [&] { MicroBench::doNotOptimize(Input::getAction("jump")); });
+    bench("Input::getAction (unbound)", [&] { MicroBench::doNotOptimize(Input::getAction("unbound")); });
+    bench("Keyboard::getKeyByString", [&] { MicroBench::doNotOptimize(Keyboard::getKeyByString("space")); });
+
+    bench("Actor::getComponentByType", [&] { MicroBench::doNotOptimize(target->getComponentByType("Idle")); });
+    bench("ActorsGuild::getActorByName (hit)", [&] { MicroBench::doNotOptimize(ActorsGuild::getActorByName("finder")); });
+    bench("ActorsGuild::getActorByName (miss)", [&] { MicroBench::doNotOptimize(ActorsGuild::getActorByName("missing")); });
+    bench("ComponentManager::getComponentInstance", [&] { MicroBench::doNotOptimize(ComponentManager::getComponentInstance("Mover")); });
+
+    bench("Renderer::queueImageExtended", [&] {
+        Renderer::queueImageExtended("square", 1.0f, 2.0f, 45.0f, 1.0f, 1.0f, 0.5f, 0.5f, 255, 255, 255, 255, 3);
+        // Drops the recorded frame now and then so the queue doesn't grow for the whole run
+        if (++queued == 8192) {
+            Renderer::swapFrames();
+            Renderer::swapFrames();
+            queued = 0;
+        }
+    });
+
+    if (json) {
+        MicroBench::printJson(std::cout, results);
+    }
+    return 0;
+}
@@ -0,0 +1,24 @@
+ActionPoller = {
+	actions = 32,
+	polls = 20000,
+
+	OnStart = function(self)
+		local keys = "abcdefghijklmnopqrstuvwxyz0123456789"
+		self.names = {}
+		for i = 1, self.actions do
+			local key = keys:sub((i - 1) % #keys + 1, (i - 1) % #keys + 1)
+			self.names[i] = "action" .. i
+			Input.AddInputBinding(self.names[i], "keyboard", key)
+		end
+	end,
+
+	OnUpdate = function(self)
+		local pressed = 0
+		for i = 1, self.polls do
+			if Input.GetAction(self.names[i % self.actions + 1]) then
+				pressed = pressed + 1
+			end
+		end
+		self.pressed = pressed
+	end
+}
@@ -0,0 +1,17 @@
+Churn = {
+	count = 200,
+
+	-- Every frame destroys the actors instantiated the frame before
+	OnStart = function(self)
+		self.alive = {}
+	end,
+
+	OnUpdate = function(self)
+		for i = 1, #self.alive do
+			Actor.Destroy(self.alive[i])
+		end
+		for i = 1, self.count do
+			self.alive[i] = Actor.Instantiate("churner")
+		end
+	end
+}
@@ -0,0 +1,21 @@
+Finder = {
+	actors = 10000,
+	finds = 200,
+
+	OnStart = function(self)
+		for i = 1, self.actors do
+			Actor.Instantiate("target")
+		end
+	end,
+
+	-- Half the lookups miss and scan every actor
+	OnUpdate = function(self)
+		for i = 1, self.finds do
+			if i % 2 == 0 then
+				Actor.Find("target")
+			else
+				Actor.Find("missing")
+			end
+		end
+	end
+}
@@ -0,0 +1,4 @@
+-- Attached but never called, measures the per-actor cost of the update passes alone
+Idle = {
+	value = 0
+}
@@ -0,0 +1,17 @@
+Mover = {
+	x = 0,
+	y = 0,
+	vx = 0.013,
+	vy = 0.007,
+
+	OnUpdate = function(self)
+		self.x = self.x + self.vx
+		self.y = self.y + self.vy
+		if self.x > 3 or self.x < -3 then
+			self.vx = -self.vx
+		end
+		if self.y > 2 or self.y < -2 then
+			self.vy = -self.vy
+		end
+	end
+}
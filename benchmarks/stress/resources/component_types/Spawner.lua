@@ -0,0 +1,10 @@
+Spawner = {
+	template = "idle",
+	count = 10000,
+
+	OnStart = function(self)
+		for i = 1, self.count do
+			Actor.Instantiate(self.template)
+		end
+	end
+}
@@ -0,0 +1,13 @@
+SpriteSpam = {
+	count = 50000,
+
+	-- Spread over the camera view so culling keeps them all
+	OnUpdate = function(self)
+		local frame = Application.GetFrame()
+		for i = 1, self.count do
+			local x = (i % 320) * 0.02 - 3.2
+			local y = ((i // 320) % 180) * 0.02 - 1.8
+			Image.DrawEx("square", x, y, (i + frame) % 360, 0.5, 0.5, 0.5, 0.5, 255, 255, 255, 128, i % 8)
+		end
+	end
+}
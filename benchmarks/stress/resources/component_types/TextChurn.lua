@@ -0,0 +1,11 @@
+TextChurn = {
+	count = 200,
+
+	-- Every string is new every frame, needs resources/fonts/bench.ttf (run.py copies a system font there)
+	OnUpdate = function(self)
+		local frame = Application.GetFrame()
+		for i = 1, self.count do
+			Text.Draw("score " .. (frame * self.count + i), (i % 10) * 60, (i // 10) * 18, "bench", 14, 255, 255, 255, 255)
+		end
+	end
+}
@@ -0,0 +1,8 @@
+-- Time.DeltaTime covers the rendered frame without a fixed rate, it must never read 0 once running
+TimeCheck = {
+	OnUpdate = function(self)
+		if Time.DeltaTime <= 0 then
+			Debug.LogError("check failed: Time.DeltaTime is " .. Time.DeltaTime .. " on frame " .. Application.GetFrame())
+		end
+	end
+}
@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+"""Runs the stress scenes headless and compares them against a stored baseline.
+
+Each scene in resources/scenes is run with
+    <engine> --headless --frames N --scene <scene>
+from this directory, and the report the engine prints at exit is parsed into
+results.json. Build the engine with `make bench` to get allocation counts, per
+subsystem as well, and pass --allocation-sites N to sample the top allocating call
+sites (one allocation in N records its stack).
+
+A scene that logs a "check failed:" error counts as failed, time_check uses that
+to make sure Time.DeltaTime is never 0 in the default loop.
+
+With --instances N the --scaling-scene is also run as one and as N engine
+instances in one process (--instances on the engine), and the summed fps of
+the N is compared with N times the single instance's: every instance has to
+print its report, a crash or a missing report fails the run.
+
+A metric counts as a regression when it is more than --threshold (15% by default)
+worse than the baseline. The exit code is 1 if any scene regressed or failed.
+"""
+
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+RESOURCES = os.path.join(HERE, "resources")
+
+# Lower is better for all of them
+METRICS = ["p50_ms", "p99_ms", "allocations_per_frame", "lua_heap_kb"]
+# Subsystem tags of the engine's allocation report
+ALLOCATION_TAGS = ["other", "actors", "renderer", "input", "lua"]
+
+SYSTEM_FONTS = [
+    "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+    "/usr/share/fonts/TTF/DejaVuSans.ttf",
+    "/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
+    "/System/Library/Fonts/Supplemental/Arial.ttf",
+    "C:/Windows/Fonts/arial.ttf",
+]
+
+
+def list_scenes():
+    folder = os.path.join(RESOURCES, "scenes")
+    return sorted(name[:-len(".scene")] for name in os.listdir(folder) if name.endswith(".scene"))
+
+
+def ensure_font(font):
+    """text_churn needs resources/fonts/bench.ttf, fonts aren't checked in."""
+    target = os.path.join(RESOURCES, "fonts", "bench.ttf")
+    if os.path.exists(target):
+        return True
+    candidates = [font] if font else SYSTEM_FONTS
+    for candidate in candidates:
+        if candidate and os.path.exists(candidate):
+            os.makedirs(os.path.dirname(target), exist_ok=True)
+            shutil.copyfile(candidate, target)
+            return True
+    return False
+
+
+def parse_report(output):
+    report = {"allocation_sites": []}
+    for line in output.splitlines():
+        if line.startswith("allocation site "):
+            report["allocation_sites"].append(line.partition(": ")[2])
+            continue
+        if line.startswith("frame ms:"):
+            for name, value in re.findall(r"(p50|p90|p99|max) ([0-9.]+)", line):
+                report[name + "_ms"] = float(value)
+            continue
+        key, _, value = line.partition(":")
+        key = key.strip().replace(" ", "_")
+        try:
+            report[key] = float(value)
+        except ValueError:
+            pass
+    return report
+
+
+def run_scene(engine, scene, frames, allocation_sites):
+    command = [engine, "--headless", "--frames", str(frames), "--scene", scene]
+    environment = dict(os.environ)
+    if allocation_sites:
+        environment["ALLOCATION_SITES"] = str(allocation_sites)
+    completed = subprocess.run(command, cwd=HERE, capture_output=True, text=True, env=environment)
+    report = parse_report(completed.stdout)
+    if completed.returncode != 0 or "fps" not in report:
+        return {"error": (completed.stdout + completed.stderr).strip()[-500:]}
+    # Scenes like time_check log "check failed: ..." when the engine misbehaves
+    failures = [line for line in completed.stderr.splitlines() if "check failed:" in line]
+    if failures:
+        return {"error": "\n".join(failures[:5])}
+    return {
+        "fps": report["fps"],
+        "p50_ms": report.get("p50_ms"),
+        "p90_ms": report.get("p90_ms"),
+        "p99_ms": report.get("p99_ms"),
+        "max_ms": report.get("max_ms"),
+        "lua_heap_kb": report.get("lua_heap_kb"),
+        "allocations_per_frame": report.get("allocations_per_frame"),
+        "allocated_kb_per_frame": report.get("allocated_kb_per_frame"),
+        "allocations_per_frame_by_tag": {tag: report["allocations_per_frame_" + tag] for tag in ALLOCATION_TAGS if "allocations_per_frame_" + tag in report},
+        "allocation_sites": report["allocation_sites"],
+        # The engine prints its memory report periodically and at exit, the last one wins
+        "memory": {key[len("memory_"):]: value for key, value in report.items() if key.startswith("memory_")},
+    }
+
+
+def run_instances(engine, scene, frames, instances):
+    """fps of every instance, a list of one for a single instance run."""
+    command = [engine, "--headless", "--frames", str(frames), "--scene", scene, "--instances", str(instances)]
+    completed = subprocess.run(command, cwd=HERE, capture_output=True, text=True)
+    # Every instance prints one report, extra instances start theirs with "instance: k"
+    fps = [float(value) for value in re.findall(r"^fps: ([0-9.]+)$", completed.stdout, re.MULTILINE)]
+    if completed.returncode != 0 or len(fps) != instances:
+        return {"error": "%d of %d reports, exit code %d: %s" % (len(fps), instances, completed.returncode, (completed.stdout + completed.stderr).strip()[-500:])}
+    return {"fps": fps}
+
+
+def measure_scaling(engine, scene, frames, instances):
+    single = run_instances(engine, scene, frames, 1)
+    if "error" in single:
+        return single
+    several = run_instances(engine, scene, frames, instances)
+    if "error" in several:
+        return several
+    total = sum(several["fps"])
+    return {
+        "scene": scene,
+        "instances": instances,
+        "single_fps": single["fps"][0],
+        "total_fps": total,
+        "min_instance_fps": min(several["fps"]),
+        # 1.0 is linear scaling
+        "efficiency": total / (instances * single["fps"][0]) if single["fps"][0] > 0 else 0.0,
+    }
+
+
+def compare(results, baseline, threshold):
+    regressions = []
+    for scene, current in results.items():
+        expected = baseline.get(scene)
+        if expected is None or "error" in current:
+            continue
+        for metric in METRICS:
+            now, before = current.get(metric), expected.get(metric)
+            if now is None or before is None or before <= 0:
+                continue
+            if now > before * (1.0 + threshold):
+                regressions.append((scene, metric, before, now))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--engine", default=os.path.join(HERE, "..", "..", "game_engine_bench"))
+    parser.add_argument("--frames", type=int, default=600)
+    parser.add_argument("--scenes", nargs="*", help="defaults to every scene")
+    parser.add_argument("--output", default=os.path.join(HERE, "results.json"))
+    parser.add_argument("--baseline", default=os.path.join(HERE, "baseline.json"))
+    parser.add_argument("--update-baseline", action="store_true", help="store this run as the new baseline")
+    parser.add_argument("--threshold", type=float, default=0.15)
+    parser.add_argument("--font", help="TTF to use for text_churn, a system font is picked otherwise")
+    parser.add_argument("--allocation-sites", type=int, default=0, metavar="N", help="sample 1 in N allocations for the top call sites")
+    parser.add_argument("--instances", type=int, default=0, metavar="N", help="also compare N engine instances in one process against one")
+    parser.add_argument("--scaling-scene", default="transform_actors")
+    args = parser.parse_args()
+
+    engine = os.path.abspath(args.engine)
+    if not os.path.exists(engine):
+        sys.exit("engine not found: " + engine)
+
+    scenes = args.scenes or list_scenes()
+    if "text_churn" in scenes and not ensure_font(args.font):
+        print("skipping text_churn: no font, pass --font")
+        scenes.remove("text_churn")
+
+    results = {}
+    for scene in scenes:
+        results[scene] = run_scene(engine, scene, args.frames, args.allocation_sites)
+        if "error" in results[scene]:
+            print("%-18s FAILED  %s" % (scene, results[scene]["error"]))
+        else:
+            r = results[scene]
+            allocations = "" if r["allocations_per_frame"] is None else "  %8.0f allocs/frame" % r["allocations_per_frame"]
+            print("%-18s %9.1f fps  p50 %7.3f ms  p99 %7.3f ms  lua %8.0f kb%s" % (scene, r["fps"], r["p50_ms"], r["p99_ms"], r["lua_heap_kb"], allocations))
+            if r["allocations_per_frame_by_tag"]:
+                print("%-18s %s" % ("", "  ".join("%s %.0f" % item for item in r["allocations_per_frame_by_tag"].items())))
+            for site in r["allocation_sites"][:5]:
+                print("%-18s   %s" % ("", site))
+
+    scaling = None
+    if args.instances > 1:
+        scaling = measure_scaling(engine, args.scaling_scene, args.frames, args.instances)
+        if "error" in scaling:
+            print("%-18s FAILED  %s" % ("instances", scaling["error"]))
+        else:
+            print("%-18s 1 at %.1f fps, %d at %.1f fps total (slowest %.1f), %.0f%% of linear" % (
+                "instances", scaling["single_fps"], scaling["instances"], scaling["total_fps"],
+                scaling["min_instance_fps"], scaling["efficiency"] * 100.0))
+
+    with open(args.output, "w") as f:
+        json.dump({"frames": args.frames, "scenes": results, "scaling": scaling}, f, indent=2, sort_keys=True)
+
+    if args.update_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump({"frames": args.frames, "scenes": results}, f, indent=2, sort_keys=True)
+        print("baseline written to " + args.baseline)
+        return 0
+
+    failed = any("error" in r for r in results.values()) or (scaling is not None and "error" in scaling)
+    if not os.path.exists(args.baseline):
+        print("no baseline at %s, run with --update-baseline to create one" % args.baseline)
+        return 1 if failed else 0
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    regressions = compare(results, baseline.get("scenes", {}), args.threshold)
+    for scene, metric, before, now in regressions:
+        print("REGRESSION %s %s: %.3f -> %.3f (+%.0f%%)" % (scene, metric, before, now, (now / before - 1.0) * 100.0))
+    if not regressions:
+        print("no regressions against " + args.baseline)
+    return 1 if regressions or failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
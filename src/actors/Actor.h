@@ -4,6 +4,8 @@
 #include <map>
 #include "../databases/BaseDB.h"
 #include "ComponentManager.h"
+#include "../utils/AllocationTracker.h"
+#include "../utils/Logger.h"
 
 #include <map>
 
@@ -38,8 +40,7 @@ public:
                 updateActor(it->second);
             }
             else {
-                std::cout << "error: template " << templateName << " is missing";
-                exit(0);
+                Logger::fatal("error: template ", templateName, " is missing");
             }
         }
         updateActor(actorDatadoc);
@@ -74,7 +75,7 @@ public:
     }
 
     luabridge::LuaRef getComponentByKey(const std::string& componentName) {
-        luabridge::LuaRef returnValue = luabridge::LuaRef(ComponentManager::luaState);
+        luabridge::LuaRef returnValue = luabridge::LuaRef(ComponentManager::getLuaState());
 
         // Return nil if component is to be removed
         for (const auto& toBeRemovedComponentName : componentsToRemove) {
@@ -92,7 +93,7 @@ public:
     }
 
     luabridge::LuaRef getComponentByType(const std::string& componentType) {
-        luabridge::LuaRef returnValue = luabridge::LuaRef(ComponentManager::luaState);
+        luabridge::LuaRef returnValue = luabridge::LuaRef(ComponentManager::getLuaState());
         bool invalidComponent = false;
 
         for (const auto& component : justAddedComponents) {
@@ -125,7 +126,7 @@ public:
     }
 
     luabridge::LuaRef getComponentsByType(const std::string& componentType) {
-        luabridge::LuaRef componentsTable = luabridge::newTable(ComponentManager::luaState);
+        luabridge::LuaRef componentsTable = luabridge::newTable(ComponentManager::getLuaState());
         bool invalidComponent = false;
         int i = 1;
 
@@ -155,10 +156,9 @@ public:
     }
 
     luabridge::LuaRef addComponent(const std::string& componentType) {
-        std::string componentName = "r" + std::to_string(ComponentManager::addComponentCount);
+        std::string componentName = "r" + std::to_string(ComponentManager::nextAddedComponent());
         justAddedComponents[componentName] = std::make_shared<Component>(componentName, componentType);
         injectActorReferences(justAddedComponents[componentName]);
-        ComponentManager::addComponentCount++;
 
         return justAddedComponents[componentName]->component;
     }
@@ -179,6 +179,7 @@ public:
 
             try {
                 if (enabled.cast<bool>() && OnStart.isFunction()) {
+                    ALLOCATION_SCOPE(Lua);
                     OnStart(component.second->component);
                 }
             }
@@ -202,6 +203,7 @@ public:
 
             try {
                 if (enabled.cast<bool>() && OnUpdate.isFunction()) {
+                    ALLOCATION_SCOPE(Lua);
                     OnUpdate(component.second->component);
                 }
             }
@@ -218,6 +220,7 @@ public:
 
             try {
                 if (enabled.cast<bool>() && OnLateUpdate.isFunction()) {
+                    ALLOCATION_SCOPE(Lua);
                     OnLateUpdate(component.second->component);
                 }
             }
@@ -227,6 +230,24 @@ public:
         }
     }
 
+    // Once per rendered frame with a fixed timestep, see GameTime
+    void renderUpdate() {
+        for (const auto& component : components) {
+            luabridge::LuaRef OnRender = component.second->component["OnRender"];
+            luabridge::LuaRef enabled = component.second->component["enabled"];
+
+            try {
+                if (enabled.cast<bool>() && OnRender.isFunction()) {
+                    ALLOCATION_SCOPE(Lua);
+                    OnRender(component.second->component);
+                }
+            }
+            catch (const luabridge::LuaException& e) {
+                reportError(e);
+            }
+        }
+    }
+
     void processRemovedComponents() {
         for (const auto& component : componentsToRemove) {
             components.erase(component);
@@ -241,6 +262,7 @@ public:
 
             try {
                 if (enabled.cast<bool>() && onDestroy.isFunction()) {
+                    ALLOCATION_SCOPE(Lua);
                     onDestroy(component.second->component);
                 }
             }
@@ -257,7 +279,7 @@ public:
         std::replace(error_message.begin(), error_message.end(), '\\', '/');
 
         // Display error with color codes
-        std::cout << "\033[31m" << actorName << " : " << error_message << "\033[0m" << std::endl;
+        Logger::output(Logger::Lua, "\033[31m", actorName, " : ", error_message, "\033[0m\n");
     }
 
     bool operator==(const Actor& other) const {
@@ -4,6 +4,7 @@
 
 #include "../databases/ResourcesDB.h"
 #include "../databases/SceneDB.h"
+#include "../utils/Profiler.h"
 #include "../utils/Timer.h"
 #include "Actor.h"
 #include "ComponentManager.h"
@@ -12,94 +13,146 @@ class ActorsGuild
 {
 public:
     ~ActorsGuild() {
-        members.clear();
-        templates.clear();
+        State& s = state();
+        s.members.clear();
+        s.templates.clear();
     }
 
     ActorsGuild() = default;
 
     static ActorsGuild* getInstance() {
-        return instance;
+        return state().instance;
     }
 
     static void init(const ResourcesDB& configDB) {
-        if (instance == nullptr) {
-            instance = new ActorsGuild(configDB);
+        State& s = state();
+        if (s.instance == nullptr) {
+            s.instance = new ActorsGuild(configDB);
         }
     }
 
     static void update() {
+        State& s = state();
         // update actors to add
-        for (auto& actor : actorsToAdd) {
-            members.push_back(std::move(actor));
+        for (auto& actor : s.actorsToAdd) {
+            s.members.push_back(std::move(actor));
         }
-        actorsToAdd.clear();
+        s.actorsToAdd.clear();
 
         // start update for any new components
-        for (auto& actor : members) {
-            actor->start();
+        {
+            PROFILE_ZONE("ActorsGuild::start");
+            for (auto& actor : s.members) {
+                actor->start();
+            }
         }
 
         // add components to actors
-        for (auto& actor : members) {
-            actor->processAddedComponents();
+        {
+            PROFILE_ZONE("ActorsGuild::processAddedComponents");
+            for (auto& actor : s.members) {
+                actor->processAddedComponents();
+            }
         }
 
         // normal update
-        for (auto& actor : members) {
-            actor->update();
+        {
+            PROFILE_ZONE("ActorsGuild::update");
+            for (auto& actor : s.members) {
+                actor->update();
+            }
         }
 
         // late update
-        for (auto& actor : members) {
-            actor->lateUpdate();
+        {
+            PROFILE_ZONE("ActorsGuild::lateUpdate");
+            for (auto& actor : s.members) {
+                actor->lateUpdate();
+            }
         }
 
         // remove components
-        for (auto& actor : members) {
-            actor->processRemovedComponents();
+        {
+            PROFILE_ZONE("ActorsGuild::processRemovedComponents");
+            for (auto& actor : s.members) {
+                actor->processRemovedComponents();
+            }
         }
 
         // remove actors
-        for (auto& actor : actorsToDestroy) {
+        PROFILE_ZONE("ActorsGuild::removeActors");
+        for (auto& actor : s.actorsToDestroy) {
             //actor->onDestroy();
-            members.erase(std::remove_if(members.begin(), members.end(), [&actor](const std::shared_ptr<Actor>& a) { return a->actorId == actor->actorId; }), members.end());
+            s.members.erase(std::remove_if(s.members.begin(), s.members.end(), [&actor](const std::shared_ptr<Actor>& a) { return a->actorId == actor->actorId; }), s.members.end());
+        }
+    }
+
+    // OnRender on every component that has started
+    static void renderUpdate() {
+        PROFILE_ZONE("ActorsGuild::renderUpdate");
+        for (auto& actor : state().members) {
+            actor->renderUpdate();
         }
     }
 
     static void loadActors(const SceneDB& database) {
+        State& s = state();
         Timer t;
         t.start();
+        std::vector<Datadoc> actorsData = prepareActors(database);
+        s.members.reserve(s.members.size() + actorsData.size());
+        s.actorsToAdd.reserve(s.actorsToAdd.size() + actorsData.size());
+        for (const auto& actorDatadoc : actorsData) {
+            s.actorsToAdd.push_back(buildActor(actorDatadoc));
+        }
+        t.stop();
+        //std::cerr << "finished loading actors\n" << t;
+    }
+
+    // Copies each actor entry of a scene into its own Datadoc
+    // Doesn't touch Lua, so it is safe to call off the main thread
+    static std::vector<Datadoc> prepareActors(const SceneDB& database) {
+        std::vector<Datadoc> actorsData;
         // Assuming the sceneDB has a "actors" array
         if (!database.mainDoc.doc.HasMember("actors") || !database.mainDoc.doc["actors"].IsArray()) {
             //std::cerr << "Scene file does not have an 'actors' array\n";
-            return;
+            return actorsData;
         }
 
         const rapidjson::Value& actorsArray = database.mainDoc.doc["actors"];
-        members.reserve(actorsArray.Size());
-        actorsToAdd.reserve(actorsArray.Size());
-        std::string actorName;
-        Datadoc actorDatadoc;
+        actorsData.reserve(actorsArray.Size());
         for (rapidjson::SizeType i = 0; i < actorsArray.Size(); ++i) {
-            // Convert actorData to a Datadoc
-            actorDatadoc = Datadoc(actorsArray[i]);
+            actorsData.emplace_back(actorsArray[i]);
+        }
+        return actorsData;
+    }
 
-            // Create actor
-            actorsToAdd.push_back(std::make_shared<Actor>(nextActorId++, actorDatadoc, templates));
+    // Creates an actor and its components from prepared scene data, must run on the main thread
+    static std::shared_ptr<Actor> buildActor(const Datadoc& actorDatadoc) {
+        State& s = state();
+        // Create actor
+        auto actor = std::make_shared<Actor>(s.nextActorId++, actorDatadoc, s.templates);
 
-            // Add Components
-            if (actorsArray[i].HasMember("components") && actorsArray[i]["components"].IsObject()) {
-                loadComponentsOnActor(actorsArray[i]["components"], actorsToAdd.back()->justAddedComponents);
-            }
+        // Add Components
+        if (actorDatadoc.doc.HasMember("components") && actorDatadoc.doc["components"].IsObject()) {
+            loadComponentsOnActor(actorDatadoc.doc["components"], actor->justAddedComponents);
+        }
 
-            // Inject Actor References
-            for (const auto& component : actorsToAdd.back()->justAddedComponents) {
-                actorsToAdd.back()->injectActorReferences(component.second);
-            }
+        // Inject Actor References
+        for (const auto& component : actor->justAddedComponents) {
+            actor->injectActorReferences(component.second);
         }
-        t.stop();
-        //std::cerr << "finished loading actors\n" << t;
+        return actor;
+    }
+
+    // Hands actors built outside the guild (async scene loads) over to be started next update
+    static void adoptActors(std::vector<std::shared_ptr<Actor>>& actors) {
+        State& s = state();
+        s.actorsToAdd.reserve(s.actorsToAdd.size() + actors.size());
+        for (auto& actor : actors) {
+            s.actorsToAdd.push_back(std::move(actor));
+        }
+        actors.clear();
     }
 
     static void loadComponentsOnActor(const rapidjson::Value& c, std::map<std::string, std::shared_ptr<Component>>& components) {
@@ -130,16 +183,18 @@ public:
     }  
 
     static std::shared_ptr<Actor>& getActorById(const size_t key) {
-        return members[key - templates.size()];
+        State& s = state();
+        return s.members[key - s.templates.size()];
     }
 
     static luabridge::LuaRef getActorByName(const std::string& name) {
-        luabridge::LuaRef returnValue = luabridge::LuaRef(ComponentManager::luaState);
+        State& s = state();
+        luabridge::LuaRef returnValue = luabridge::LuaRef(ComponentManager::getLuaState());
         bool invalidActor = false;
 
-        for (const auto& actor : actorsToAdd) {
+        for (const auto& actor : s.actorsToAdd) {
             if (actor->getName() == name) {
-                for (const auto& toBeDestroyedActor : actorsToDestroy) {
+                for (const auto& toBeDestroyedActor : s.actorsToDestroy) {
                     invalidActor = actor->actorId == toBeDestroyedActor->actorId;
                 }
                 if (!invalidActor) {
@@ -148,9 +203,9 @@ public:
                 }
             }
         }
-        for (const auto& actor : members) {
+        for (const auto& actor : s.members) {
             if (actor->getName() == name) {
-                for (const auto& toBeDestroyedActor : actorsToDestroy) {
+                for (const auto& toBeDestroyedActor : s.actorsToDestroy) {
                     invalidActor = actor->actorId == toBeDestroyedActor->actorId;
                 }
                 if (!invalidActor) {
@@ -163,13 +218,14 @@ public:
     }
 
     static luabridge::LuaRef getActorsByName(const std::string& name) {
-        luabridge::LuaRef actorsTable = luabridge::newTable(ComponentManager::luaState);
+        State& s = state();
+        luabridge::LuaRef actorsTable = luabridge::newTable(ComponentManager::getLuaState());
         bool invalidActor = false;
         int i = 1;
 
-        for (const auto& actor : actorsToAdd) {
+        for (const auto& actor : s.actorsToAdd) {
             if (actor->getName() == name) {
-                for (const auto& toBeDestroyedActor : actorsToDestroy) {
+                for (const auto& toBeDestroyedActor : s.actorsToDestroy) {
                     invalidActor = actor->actorId == toBeDestroyedActor->actorId;
                 }
                 if (!invalidActor) {
@@ -177,9 +233,9 @@ public:
                 }
             }
         }
-        for (const auto& actor : members) {
+        for (const auto& actor : s.members) {
             if (actor->getName() == name) {
-                for (const auto& toBeDestroyedActor : actorsToDestroy) {
+                for (const auto& toBeDestroyedActor : s.actorsToDestroy) {
                     invalidActor = actor->actorId == toBeDestroyedActor->actorId;
                 }
                 if (!invalidActor) {
@@ -191,13 +247,14 @@ public:
     }
 
     static luabridge::LuaRef instantiateActorFromTemplate(const std::string& templateName) {
-        if (auto it = templates.find(templateName); it != templates.end()) {
-            actorsToAdd.push_back(std::make_shared<Actor>(nextActorId++));
-            actorsToAdd.back()->updateActor(it->second);
-            for (const auto& component : actorsToAdd.back()->justAddedComponents) {
-                actorsToAdd.back()->injectActorReferences(component.second);
+        State& s = state();
+        if (auto it = s.templates.find(templateName); it != s.templates.end()) {
+            s.actorsToAdd.push_back(std::make_shared<Actor>(s.nextActorId++));
+            s.actorsToAdd.back()->updateActor(it->second);
+            for (const auto& component : s.actorsToAdd.back()->justAddedComponents) {
+                s.actorsToAdd.back()->injectActorReferences(component.second);
             }
-            return actorToLuaRef(actorsToAdd.back());
+            return actorToLuaRef(s.actorsToAdd.back());
         }
         else {
             //std::cerr << "error: template " << templateName << " is missing";
@@ -212,54 +269,65 @@ public:
         for (auto& component : actor.components) {
             actor.removeComponent(component.second->component);
         }
-        actorsToDestroy.push_back(std::make_shared<Actor>(actor));
+        state().actorsToDestroy.push_back(std::make_shared<Actor>(actor));
     }
 
     static luabridge::LuaRef actorToLuaRef(std::shared_ptr<Actor> actor) {
         // Push the actor onto the Lua stack
-        luabridge::push(ComponentManager::luaState, actor.get());
+        luabridge::push(ComponentManager::getLuaState(), actor.get());
 
         // Create LuaRef from the object on the top of the stack
-        luabridge::LuaRef ref = luabridge::LuaRef::fromStack(ComponentManager::luaState, -1);
+        luabridge::LuaRef ref = luabridge::LuaRef::fromStack(ComponentManager::getLuaState(), -1);
 
         // Now pop the actor back off the stack since LuaRef has a copy
-        lua_pop(ComponentManager::luaState, 1);
+        lua_pop(ComponentManager::getLuaState(), 1);
 
         return ref;
     }
 
     static void clear() {
-        for (auto& actor : actorsToAdd) {
-            members.push_back(std::move(actor));
+        State& s = state();
+        for (auto& actor : s.actorsToAdd) {
+            s.members.push_back(std::move(actor));
         }
-        actorsToAdd.clear();
+        s.actorsToAdd.clear();
 
-        for (auto& actor : members) {
+        for (auto& actor : s.members) {
             if (!actor->dontDestroyOnLoad) {
                 destroyActor(*actor);
             }
         }
 
-        for (auto& actor : actorsToDestroy) {
+        for (auto& actor : s.actorsToDestroy) {
             //actor->onDestroy();
-            members.erase(std::remove_if(members.begin(), members.end(), [&actor](const std::shared_ptr<Actor>& a) { return a->actorId == actor->actorId; }), members.end());
+            s.members.erase(std::remove_if(s.members.begin(), s.members.end(), [&actor](const std::shared_ptr<Actor>& a) { return a->actorId == actor->actorId; }), s.members.end());
         }
-        actorsToDestroy.clear();
+        s.actorsToDestroy.clear();
     }
 
-    static inline std::vector<std::shared_ptr<Actor>> members = {};
-    static inline std::vector<std::shared_ptr<Actor>> actorsToAdd = {};
-    static inline std::vector<std::shared_ptr<Actor>> actorsToDestroy = {};
+    static const std::vector<std::shared_ptr<Actor>>& getMembers() { return state().members; }
+    static const std::vector<std::shared_ptr<Actor>>& getActorsToAdd() { return state().actorsToAdd; }
+    static const std::vector<std::shared_ptr<Actor>>& getActorsToDestroy() { return state().actorsToDestroy; }
 private:
-    static inline ActorsGuild* instance = nullptr;
-    static inline int nextActorId = 0;
-    static inline std::map<std::string, std::shared_ptr<Actor>> templates = {};
+    friend class EngineContext;
+
+    struct State {
+        std::vector<std::shared_ptr<Actor>> members = {};
+        std::vector<std::shared_ptr<Actor>> actorsToAdd = {};
+        std::vector<std::shared_ptr<Actor>> actorsToDestroy = {};
+        ActorsGuild* instance = nullptr;
+        int nextActorId = 0;
+        std::map<std::string, std::shared_ptr<Actor>> templates = {};
+    };
+
+    static State& state();
 
     ActorsGuild(const ResourcesDB& configDB) {
-        instance = this;
+        State& s = state();
+        s.instance = this;
 
         // Register Actor namespace with lua
-        luabridge::getGlobalNamespace(ComponentManager::luaState)
+        luabridge::getGlobalNamespace(ComponentManager::getLuaState())
             .beginNamespace("Actor")
             .addFunction("Find", &ActorsGuild::getActorByName)
             .addFunction("FindAll", &ActorsGuild::getActorsByName)
@@ -268,7 +336,7 @@ private:
             .endNamespace();
 
         // Register Actor class with Lua
-        luabridge::getGlobalNamespace(ComponentManager::luaState)
+        luabridge::getGlobalNamespace(ComponentManager::getLuaState())
             .beginClass<Actor>("actor")
             .addFunction("GetName", &Actor::getName)
             .addFunction("GetID", &Actor::getID)
@@ -286,11 +354,11 @@ private:
         t.start();
         for (const auto& temp : configDB.templates) {
             // Create actor
-            templates[temp.first] = std::make_shared<Actor>(nextActorId++, temp.second);
+            s.templates[temp.first] = std::make_shared<Actor>(s.nextActorId++, temp.second);
 
             // Add Components
             if (temp.second.doc.HasMember("components") && temp.second.doc["components"].IsObject()) {
-                loadComponentsOnActor(temp.second.doc["components"], templates[temp.first]->justAddedComponents);
+                loadComponentsOnActor(temp.second.doc["components"], s.templates[temp.first]->justAddedComponents);
             }
         }
 
@@ -1,8 +1,13 @@
 #include "ComponentManager.h"
 
 #include <glm/vec2.hpp>
+#include "../core/Engine.h"
+#include "../core/EngineContext.h"
+#include "../databases/AssetArchive.h"
+#include "../utils/AllocationTracker.h"
+#include "../utils/Logger.h"
 
-Component::Component() : name(""), type(""), component(luabridge::newTable(ComponentManager::luaState)) {
+Component::Component() : name(""), type(""), component(luabridge::newTable(ComponentManager::getLuaState())) {
     addDefaultProperties();
 }
 
@@ -11,7 +16,7 @@ Component::Component(const std::string& name, const std::string& type)
     addDefaultProperties();
 }
 
-Component::Component(Component& other) : name(other.name), type(other.type), component(luabridge::newTable(ComponentManager::luaState))
+Component::Component(Component& other) : name(other.name), type(other.type), component(luabridge::newTable(ComponentManager::getLuaState()))
 {
     ComponentManager::getInstance()->establishInstance(component, other.component);
 }
@@ -43,36 +48,60 @@ void Component::addBoolProperty(const std::string& key, const bool value)
 }
 
 ComponentManager* ComponentManager::getInstance() {
-    if (instance == nullptr) {
-        instance = new ComponentManager();
+    State& s = state();
+    if (s.instance == nullptr) {
+        s.instance = new ComponentManager();
     }
-    return instance;
+    return s.instance;
+}
+
+ComponentManager::State::~State() {
+    originalComponents.clear();
+    if (luaState != nullptr) {
+        lua_close(luaState);
+    }
+}
+
+lua_State* ComponentManager::getLuaState() {
+    return state().luaState;
+}
+
+int ComponentManager::nextAddedComponent() {
+    return state().addComponentCount++;
 }
 
 void ComponentManager::initState() {
-    luaState = luaL_newstate();
-    luaL_openlibs(luaState);
+    State& s = state();
+    s.luaState = luaL_newstate();
+    // Same realloc/free pairing as the default allocator, swapping it on a fresh state is safe
+    if (AllocationTracker::isEnabled()) {
+        lua_setallocf(s.luaState, &AllocationTracker::luaAlloc, nullptr);
+    }
+    luaL_openlibs(s.luaState);
+    // Lua's own print writes to C stdout straight away and would overtake Debug.Log lines still queued in Logger
+    lua_register(s.luaState, "print", &luaPrint);
 }
 
 void ComponentManager::initFunctions() {
+    State& s = state();
     // Debug API functions
-    luabridge::getGlobalNamespace(luaState)
+    luabridge::getGlobalNamespace(s.luaState)
         .beginNamespace("Debug")
         .addFunction("Log", &print)
         .addFunction("LogError", &printError)
         .endNamespace();
 
     // Application API functions
-    luabridge::getGlobalNamespace(luaState)
+    luabridge::getGlobalNamespace(s.luaState)
         .beginNamespace("Application")
         .addFunction("Quit", &quit)
         .addFunction("Sleep", &sleep)
-        .addFunction("GetFrame", &Helper::GetFrameNumber)
+        .addFunction("GetFrame", &EngineContext::getFrameNumber)
         .addFunction("OpenURL", &openURL)
         .endNamespace();
 
     // External classes API
-    luabridge::getGlobalNamespace(luaState)
+    luabridge::getGlobalNamespace(s.luaState)
         .beginClass<glm::vec2>("vec2")
         .addProperty("x", &glm::vec2::x)
         .addProperty("y", &glm::vec2::y)
@@ -80,31 +109,95 @@ void ComponentManager::initFunctions() {
 }
 
 void ComponentManager::initComponents() {
+    State& s = state();
+    if (AssetArchive::isOpen()) {
+        initPackedComponents();
+        return;
+    }
     if (!std::filesystem::exists(componentPath)) {
         //std::cerr << "error: component path does not exist\n";
         return;
     }
     for (const auto& entry : std::filesystem::directory_iterator(componentPath)) {
-        if (const auto statusCode = luaL_dofile(luaState, entry.path().string().c_str()); statusCode != LUA_OK) {
-            std::cout << "problem with lua file " << entry.path().stem().string();
+        if (const auto statusCode = luaL_dofile(s.luaState, entry.path().string().c_str()); statusCode != LUA_OK) {
             //std::cerr << "error: " << statusCode;
-            exit(0);
+            Logger::fatal("problem with lua file ", entry.path().stem().string());
         }
 
         std::string componentName = entry.path().stem().string();
-        originalComponents.insert({ componentName, std::make_shared<luabridge::LuaRef>(luabridge::getGlobal(luaState, componentName.c_str())) });
+        s.originalComponents.insert({ componentName, std::make_shared<luabridge::LuaRef>(luabridge::getGlobal(s.luaState, componentName.c_str())) });
+    }
+}
+
+void ComponentManager::initPackedComponents() {
+    State& s = state();
+    for (const auto& path : AssetArchive::list("component_types", ".lua")) {
+        // Same chunk name luaL_dofile would use so error messages still point at the file
+        const std::string chunkName = "@resources/" + std::string(path);
+        const auto source = AssetArchive::find(std::string(path));
+        if (luaL_loadbuffer(s.luaState, source->data(), source->size(), chunkName.c_str()) != LUA_OK
+            || lua_pcall(s.luaState, 0, LUA_MULTRET, 0) != LUA_OK) {
+            Logger::fatal("problem with lua file ", AssetArchive::stem(path));
+        }
+
+        std::string componentName = AssetArchive::stem(path);
+        s.originalComponents.insert({ componentName, std::make_shared<luabridge::LuaRef>(luabridge::getGlobal(s.luaState, componentName.c_str())) });
     }
 }
 
 void ComponentManager::print(const std::string s) {
-    std::cout << s << '\n';
+    Logger::output(Logger::Lua, s, '\n');
+}
+
+int ComponentManager::luaPrint(lua_State* L) {
+    // Same formatting as the base library's print: tostring of every argument, tab separated
+    std::string line;
+    const int count = lua_gettop(L);
+    for (int i = 1; i <= count; i++) {
+        size_t length = 0;
+        const char* text = luaL_tolstring(L, i, &length);
+        if (i > 1) {
+            line += '\t';
+        }
+        line.append(text, length);
+        lua_pop(L, 1);
+    }
+    Logger::output(Logger::Lua, line, '\n');
+    return 0;
 }
 
 void ComponentManager::printError(const std::string s) {
-    std::cerr << s << '\n';
+    Logger::error(Logger::Lua, s);
+}
+
+bool ComponentManager::collectGarbage(double budgetMs) {
+    State& s = state();
+    if (lua_gc(s.luaState, LUA_GCCOUNT, 0) < s.heapKbAfterCollect + 256) {
+        return false;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const auto budget = std::chrono::duration<double, std::milli>(budgetMs);
+    do {
+        // A basic step, returns 1 when it finished a cycle
+        if (lua_gc(s.luaState, LUA_GCSTEP, 0) != 0) {
+            s.heapKbAfterCollect = lua_gc(s.luaState, LUA_GCCOUNT, 0);
+            return false;
+        }
+    } while (std::chrono::steady_clock::now() - start < budget);
+    return true;
 }
 
 void ComponentManager::quit() {
+    // Other instances keep running, only this one's loop stops
+    if (!EngineContext::current().isPrimary()) {
+        Engine::stop();
+        return;
+    }
+    // Extra instances still run Lua and render, main joins them all and exits after
+    if (Engine::getInstanceCount() > 1) {
+        Engine::stopAll();
+        return;
+    }
     exit(0);
 }
 
@@ -126,24 +219,25 @@ void ComponentManager::openURL(const std::string& url) {
 }
 
 void ComponentManager::establishInstance(luabridge::LuaRef& instanceTable, luabridge::LuaRef& sourceTable) {
+    State& s = state();
     // Create a new metatable to establish inheritance 
-    luabridge::LuaRef newMetatable = luabridge::newTable(luaState);
+    luabridge::LuaRef newMetatable = luabridge::newTable(s.luaState);
     newMetatable["__index"] = sourceTable;
 
     // Use raw lua C-API (lua stack) to preform the metatable assignment
-    instanceTable.push(luaState);
-    newMetatable.push(luaState);
-    lua_setmetatable(luaState, -2);
-    lua_pop(luaState, 1);
+    instanceTable.push(s.luaState);
+    newMetatable.push(s.luaState);
+    lua_setmetatable(s.luaState, -2);
+    lua_pop(s.luaState, 1);
 }
 
 luabridge::LuaRef ComponentManager::getComponentInstance(const std::string& componentName) {
-    const auto it = originalComponents.find(componentName);
-    if (it == originalComponents.end()) {
-        std::cout << "error: failed to locate component " << componentName;
-        exit(0);
+    State& s = state();
+    const auto it = s.originalComponents.find(componentName);
+    if (it == s.originalComponents.end()) {
+        Logger::fatal("error: failed to locate component ", componentName);
     }
-    luabridge::LuaRef instanceTable = luabridge::newTable(luaState);
+    luabridge::LuaRef instanceTable = luabridge::newTable(s.luaState);
     establishInstance(instanceTable, *it->second);
     return instanceTable;
 }
@@ -41,7 +41,7 @@ public:
     static ComponentManager* getInstance();
 
     void init() {
-        instance = this;
+        state().instance = this;
         initState();
         initFunctions();
         initComponents();
@@ -53,20 +53,47 @@ public:
 
     static void initComponents();
 
+    static void initPackedComponents();
+
     static void establishInstance(luabridge::LuaRef& instanceTable, luabridge::LuaRef& sourceTable);
 
     static luabridge::LuaRef getComponentInstance(const std::string& componentName);
 
-    static inline ComponentManager* instance = nullptr;
-    static inline lua_State* luaState = nullptr;
-    static inline int addComponentCount = 0;
+    // FramePacer idle task: incremental GC steps until the budget runs out or a cycle ends
+    static bool collectGarbage(double budgetMs);
+
+    // The running instance's Lua state
+    static lua_State* getLuaState();
+
+    // Number for the next component added at runtime, keys are "r" followed by it
+    static int nextAddedComponent();
 
 private:
-    static inline std::unordered_map<std::string, std::shared_ptr<luabridge::LuaRef>> originalComponents = {};
+    friend class EngineContext;
+
+    struct State {
+        ComponentManager* instance = nullptr;
+        lua_State* luaState = nullptr;
+        int addComponentCount = 0;
+        std::unordered_map<std::string, std::shared_ptr<luabridge::LuaRef>> originalComponents = {};
+        // Heap size when the last idle cycle ended, below this plus a margin there's nothing worth collecting
+        int heapKbAfterCollect = 0;
+
+        State() = default;
+        State(const State&) = delete;
+        State& operator=(const State&) = delete;
+        // Templates hold references into the state, they go first
+        ~State();
+    };
+
+    static State& state();
+
     static inline std::string componentPath = "resources/component_types/";
 
     static void print(const std::string s);
     static void printError(const std::string s);
+    // Replaces Lua's global print so it is ordered with Debug.Log
+    static int luaPrint(lua_State* L);
     static void quit();
     static void sleep(int durationMs);
     static void openURL(const std::string& url);
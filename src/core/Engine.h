@@ -1,49 +1,120 @@
 #ifndef ENGINE_H
 #define ENGINE_H
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "Scene.h"
+#include "LaunchOptions.h"
 #include "../input/Input.h"
 #include "../rendering/Renderer.h"
 #include "../databases/AudioDB.h"
 #include "../actors/ComponentManager.h"
+#include "../utils/AllocationTracker.h"
+#include "../utils/FrameTimeStats.h"
+
+class EngineContext;
 
 class Engine
 {
 public:
-	Engine();
+	explicit Engine(const LaunchOptions& launchOptions = LaunchOptions());
 
 	static void gameLoop();
 
 	static void setSceneToLoad(const std::string& sceneName);
 
-	static std::string getCurrentSceneName() { return currentSceneName; }
+	static std::string getCurrentSceneName() { return state().currentSceneName; }
 
 	static void markActorDontDestroyOnLoad(Actor& a);
 
+	// Application.GetFrame while pipelined or on a fixed timestep, Helper's frame number counts rendered frames
+	static int getSimulationFrame() { return state().simulationFrame; }
+
+	// Ends this instance's loop after the current frame, Application.Quit in an extra instance
+	static void stop();
+
+	// An extra instance start to finish on the calling thread, see EngineContext
+	static void runInstance(const LaunchOptions& launchOptions, int id);
+
+	// Instances whose loop hasn't finished yet, the primary one included
+	static size_t getInstanceCount();
+	// Application.Quit in the primary instance while extra ones run, main exits once they are joined
+	static void stopAll();
+	// Logger's fatal handler while extra instances run: stops every instance and returns once the others are
+	// finished, so exit() never runs under a live one. A second fatal error while that happens parks its thread.
+	static void onFatalError();
+
 private:
 	static void loadScene();
 
+	// Simulation of the next frame overlaps rendering of the current one, see FramePipeline
+	static void pipelinedGameLoop();
+	// Updates at fixed_timestep_hz, rendering every loop iteration, see GameTime
+	static void fixedStepGameLoop();
+
 	static void input();
 	static void update();
+	// OnRender, every rendered frame on a fixed timestep
+	static void renderUpdate();
 	static void render();
-	static void lateUpdate();
+	// Input edges stay for the next frame when no update saw them, the scene loader advances every frame
+	static void lateUpdate(bool inputConsumed = true);
 
 	static void shutDown();
 
-	static inline Engine* instance = nullptr;
+	// Frame time bookkeeping and the --frames/--until-scene stop conditions, call once per loop iteration
+	static void startFrameStats();
+	static void endFrame();
+	// Prints the headless run's throughput once, from shutDown or at exit
+	static void reportFrameStats();
+
+	friend class EngineContext;
+
+	struct State {
+		Engine* instance = nullptr;
+
+		// Set from other threads by stopAll
+		std::atomic<bool> running{ true };
+		bool pipelined = false;
+		int simulationFrame = 0;
+
+		LaunchOptions options;
+		FrameTimeStats frameStats;
+		int framesRun = 0;
+		bool frameStatsReported = false;
+		// Allocation count when the loop started, startup loading isn't part of the per-frame numbers
+		AllocationTracker::Counts frameStatsAllocations = {};
+		std::ostringstream out;
+
+		Renderer* renderer = nullptr;
+		ComponentManager componentManager;
+		ActorsGuild actorsGuild;
+		ResourcesDB resourcesDB;
+		AudioDB audioDB;
+
+		std::unique_ptr<Scene> currentScene = nullptr;
+		std::string currentSceneName = "";
+		std::string sceneToLoad = "";
+
+		std::thread::id loopThread;
+	};
 
-	static inline bool running = true;
-	static inline std::ostringstream out;
+	static State& state();
 
-	static inline Renderer* renderer;
-	static inline ComponentManager componentManager;
-	static inline ActorsGuild actorsGuild;
-	static inline ResourcesDB resourcesDB;
-	static inline AudioDB audioDB;
+	// Process wide, unlike State
+	static inline std::mutex instancesMutex;
+	static inline std::condition_variable instancesChanged;
+	static inline std::vector<EngineContext*> instances = {};
+	static inline bool exiting = false;
+	// Extra instances out of instances whose context is still being destroyed
+	static inline int finishingInstances = 0;
+	static inline thread_local bool finishingHere = false;
 
-	static inline std::unique_ptr<Scene> currentScene = nullptr;
-	static inline std::string currentSceneName = "";
-	static inline std::string sceneToLoad = "";
+	static void removeInstance(const EngineContext* context);
 };
 
 #endif
@@ -0,0 +1,44 @@
+#include "EngineContext.h"
+
+EngineContext::EngineContext(int id) : id(id) {}
+
+EngineContext& EngineContext::current() {
+	return bound != nullptr ? *bound : primary();
+}
+
+EngineContext& EngineContext::primary() {
+	static EngineContext* const context = new EngineContext(0);
+	return *context;
+}
+
+int EngineContext::getFrameNumber() {
+	const EngineContext& context = current();
+	// Helper counts the presents it makes, those are the primary instance's
+	return context.isPrimary() ? Helper::GetFrameNumber() : context.presentedFrames;
+}
+
+ComponentManager::State& ComponentManager::state() { return EngineContext::current().components; }
+ActorsGuild::State& ActorsGuild::state() { return EngineContext::current().actors; }
+SceneLoader::State& SceneLoader::state() { return EngineContext::current().sceneLoader; }
+GameTime::State& GameTime::state() { return EngineContext::current().gameTime; }
+FlightRecorder::State& FlightRecorder::state() { return EngineContext::current().flightRecorder; }
+MemoryStats::State& MemoryStats::state() { return EngineContext::current().memoryStats; }
+
+Input::State& Input::state() { return EngineContext::current().input; }
+Keyboard::State& Keyboard::state() { return EngineContext::current().keyboard; }
+Mouse::State& Mouse::state() { return EngineContext::current().mouse; }
+ControllerManager::State& ControllerManager::state() { return EngineContext::current().controllers; }
+
+AudioDB::State& AudioDB::state() { return EngineContext::current().audio; }
+
+Renderer::State& Renderer::state() { return EngineContext::current().renderer; }
+RenderStats::State& RenderStats::state() { return EngineContext::current().renderStats; }
+FontDB::State& FontDB::state() { return EngineContext::current().fonts; }
+GlyphAtlas::State& GlyphAtlas::state() { return EngineContext::current().glyphAtlas; }
+TextureAtlas::State& TextureAtlas::state() { return EngineContext::current().textureAtlas; }
+PixelBuffer::State& PixelBuffer::state() { return EngineContext::current().pixelBuffer; }
+SpriteBatcher::State& SpriteBatcher::state() { return EngineContext::current().spriteBatcher; }
+SpriteCuller::State& SpriteCuller::state() { return EngineContext::current().spriteCuller; }
+StatsOverlay::State& StatsOverlay::state() { return EngineContext::current().statsOverlay; }
+
+Engine::State& Engine::state() { return EngineContext::current().engine; }
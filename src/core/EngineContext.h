@@ -0,0 +1,105 @@
+#ifndef ENGINECONTEXT_H
+#define ENGINECONTEXT_H
+
+#include "Engine.h"
+#include "FlightRecorder.h"
+#include "GameTime.h"
+#include "MemoryStats.h"
+#include "SceneLoader.h"
+#include "../input/ControllerManager.h"
+#include "../input/Input.h"
+#include "../input/Keyboard.h"
+#include "../input/Mouse.h"
+#include "../rendering/FontDB.h"
+#include "../rendering/GlyphAtlas.h"
+#include "../rendering/PixelBuffer.h"
+#include "../rendering/RenderStats.h"
+#include "../rendering/SpriteBatcher.h"
+#include "../rendering/SpriteCuller.h"
+#include "../rendering/StatsOverlay.h"
+#include "../rendering/TextureAtlas.h"
+
+// Everything one running game owns, so several can run side by side in one process
+// The systems keep their static interface, Lua binds plain function pointers, and reach their state
+// through the context bound to the calling thread. main binds the primary context, every extra
+// instance binds its own on the thread it runs on, and threads an instance starts bind its context too.
+// The primary instance is the one the autograder sees: only it talks to Helper (input replay, frame
+// capture, the render logger, frame pacing), opens a window, plays audio or polls SDL events.
+// Extra instances are headless, keep their own frame count and never get input events.
+// Logger, Profiler, AllocationTracker and the asset archive stay process wide.
+class EngineContext
+{
+public:
+	// id 0 is the primary instance
+	explicit EngineContext(int id);
+
+	EngineContext(const EngineContext&) = delete;
+	EngineContext& operator=(const EngineContext&) = delete;
+
+	// The context bound to this thread, the primary one if none is
+	static EngineContext& current();
+	// Created on first use and never destroyed, atexit handlers still reach it
+	static EngineContext& primary();
+
+	// Binds a context to the calling thread for its lifetime, the previous binding comes back after
+	class Bind
+	{
+	public:
+		explicit Bind(EngineContext& context) : previous(bound) { bound = &context; }
+		~Bind() { bound = previous; }
+
+		Bind(const Bind&) = delete;
+		Bind& operator=(const Bind&) = delete;
+
+	private:
+		EngineContext* previous;
+	};
+
+	// Drops this thread's binding for good, what runs on it afterwards reaches the primary context
+	static void unbind() { bound = nullptr; }
+
+	int getId() const { return id; }
+	bool isPrimary() const { return id == 0; }
+
+	// Application.GetFrame: Helper's frame number for the primary instance, presents counted here otherwise
+	static int getFrameNumber();
+	// Called by the Renderer after an extra instance presents
+	void countPresent() { presentedFrames++; }
+
+	// Closing the Lua state runs the recorder's GC sentinel, so it outlives the state
+	FlightRecorder::State flightRecorder;
+	// Before the rest so the Lua state outlives every LuaRef the other systems hold
+	ComponentManager::State components;
+	ActorsGuild::State actors;
+	SceneLoader::State sceneLoader;
+	GameTime::State gameTime;
+	MemoryStats::State memoryStats;
+
+	Input::State input;
+	Keyboard::State keyboard;
+	Mouse::State mouse;
+	ControllerManager::State controllers;
+
+	AudioDB::State audio;
+
+	Renderer::State renderer;
+	RenderStats::State renderStats;
+	FontDB::State fonts;
+	GlyphAtlas::State glyphAtlas;
+	TextureAtlas::State textureAtlas;
+	PixelBuffer::State pixelBuffer;
+	SpriteBatcher::State spriteBatcher;
+	SpriteCuller::State spriteCuller;
+	StatsOverlay::State statsOverlay;
+
+	// Last so it goes first, the guild and databases it holds clear the states above on destruction
+	Engine::State engine;
+
+private:
+	static inline thread_local EngineContext* bound = nullptr;
+
+	const int id;
+	int presentedFrames = 0;
+};
+
+#endif
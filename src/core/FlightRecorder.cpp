@@ -0,0 +1,135 @@
+#include "FlightRecorder.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+#include "lua.hpp"
+#include "../actors/ActorsGuild.h"
+#include "../actors/ComponentManager.h"
+#include "../rendering/RenderStats.h"
+#include "EngineContext.h"
+#include "SceneLoader.h"
+#include "../utils/Logger.h"
+
+namespace {
+	constexpr const char* gcSentinelMetatable = "FlightRecorder.gcSentinel";
+	constexpr const char* phaseNames[FlightRecorder::PHASE_COUNT] = { "load_scene", "input", "update", "render", "late_update" };
+}
+
+void FlightRecorder::init(const ResourcesDB& configDB) {
+	State& s = state();
+	// Extra instances record without dumping, their spike files would take the primary instance's names
+	const bool primary = EngineContext::current().isPrimary();
+	s.ring.assign(static_cast<size_t>(std::max(configDB.mainDoc.getInt("flight_recorder_frames", 300), 1)), Record{});
+	s.budgetMs = primary ? configDB.mainDoc.getFloat("frame_budget_ms", 0.0f) : 0.0f;
+	s.postFrames = std::max(configDB.mainDoc.getInt("flight_recorder_post_frames", 60), 0);
+	s.maxDumps = configDB.mainDoc.getInt("flight_recorder_max_dumps", 16);
+	s.dumpDirectory = configDB.mainDoc.getString("flight_recorder_dir", "flight_recorder");
+
+	lua_State* L = ComponentManager::getLuaState();
+	luaL_newmetatable(L, gcSentinelMetatable);
+	lua_pushcfunction(L, &FlightRecorder::onGarbageCollected);
+	lua_setfield(L, -2, "__gc");
+	lua_pop(L, 1);
+	armGcSentinel(L);
+
+	// Application.Quit exits mid-frame, a spike near the end would otherwise never be written
+	if (primary) {
+		std::atexit(&FlightRecorder::flush);
+	}
+}
+
+void FlightRecorder::endFrame(int frame, float frameMs) {
+	State& s = state();
+	s.current.frame = frame;
+	s.current.frameMs = frameMs;
+	s.current.actors = static_cast<int>(ActorsGuild::getMembers().size());
+	s.current.actorsToAdd = static_cast<int>(ActorsGuild::getActorsToAdd().size());
+	s.current.actorsToDestroy = static_cast<int>(ActorsGuild::getActorsToDestroy().size());
+	s.current.queuedImages = RenderStats::getQueuedImages();
+	s.current.queuedText = RenderStats::getQueuedText();
+	s.current.queuedPixels = RenderStats::getQueuedPixels();
+	s.current.drawCalls = RenderStats::getDrawCalls();
+	s.current.luaHeapKb = lua_gc(ComponentManager::getLuaState(), LUA_GCCOUNT, 0);
+	s.current.gcCycles = s.gcCycles - s.gcCyclesCommitted;
+	s.current.sceneLoading = SceneLoader::isLoading();
+	s.gcCyclesCommitted = s.gcCycles;
+
+	s.ring[s.next] = s.current;
+	s.next = (s.next + 1) % s.ring.size();
+	s.count = std::min(s.count + 1, s.ring.size());
+	s.current = Record{};
+
+	if (s.spikeFrame >= 0 && --s.framesUntilDump <= 0) {
+		dump();
+	}
+	if (s.budgetMs > 0.0f && frameMs > s.budgetMs && s.spikeFrame < 0 && s.dumps < s.maxDumps) {
+		s.spikeFrame = frame;
+		s.spikeMs = frameMs;
+		s.framesUntilDump = s.postFrames;
+		if (s.framesUntilDump == 0) {
+			dump();
+		}
+	}
+}
+
+const FlightRecorder::Record& FlightRecorder::latest() {
+	State& s = state();
+	return s.ring[(s.next + s.ring.size() - 1) % s.ring.size()];
+}
+
+void FlightRecorder::flush() {
+	if (state().spikeFrame >= 0) {
+		dump();
+	}
+}
+
+void FlightRecorder::dump() {
+	State& s = state();
+	const std::filesystem::path path = std::filesystem::path(s.dumpDirectory) / ("spike_" + std::to_string(s.spikeFrame) + ".json");
+	std::error_code error;
+	std::filesystem::create_directories(s.dumpDirectory, error);
+	std::ofstream out(path, std::ios::trunc);
+
+	out << "{\n\"budget_ms\": " << s.budgetMs << ",\n\"spike_frame\": " << s.spikeFrame << ",\n\"spike_ms\": " << s.spikeMs << ",\n\"frames\": [\n";
+	const size_t oldest = (s.next + s.ring.size() - s.count) % s.ring.size();
+	for (size_t i = 0; i < s.count; i++) {
+		const Record& record = s.ring[(oldest + i) % s.ring.size()];
+		out << "{\"frame\": " << record.frame << ", \"frame_ms\": " << record.frameMs;
+		for (int phase = 0; phase < PHASE_COUNT; phase++) {
+			out << ", \"" << phaseNames[phase] << "_ms\": " << record.phaseMs[phase];
+		}
+		out << ", \"actors\": " << record.actors
+			<< ", \"actors_to_add\": " << record.actorsToAdd
+			<< ", \"actors_to_destroy\": " << record.actorsToDestroy
+			<< ", \"queued_images\": " << record.queuedImages
+			<< ", \"queued_text\": " << record.queuedText
+			<< ", \"queued_pixels\": " << record.queuedPixels
+			<< ", \"draw_calls\": " << record.drawCalls
+			<< ", \"lua_heap_kb\": " << record.luaHeapKb
+			<< ", \"gc_cycles\": " << record.gcCycles
+			<< ", \"scene_loading\": " << (record.sceneLoading ? "true" : "false")
+			<< (i + 1 < s.count ? "},\n" : "}\n");
+	}
+	out << "]\n}\n";
+
+	if (out) {
+		Logger::info(Logger::Engine, "flight recorder: frame ", s.spikeFrame, " took ", s.spikeMs, " ms, wrote ", path.string());
+	}
+	s.spikeFrame = -1;
+	s.dumps++;
+}
+
+void FlightRecorder::armGcSentinel(lua_State* L) {
+	lua_newuserdatauv(L, 0, 0);
+	luaL_setmetatable(L, gcSentinelMetatable);
+	lua_pop(L, 1);
+}
+
+int FlightRecorder::onGarbageCollected(lua_State* L) {
+	state().gcCycles++;
+	// lua_close doesn't register finalizers any more, re-arming there is harmless
+	armGcSentinel(L);
+	return 0;
+}
@@ -0,0 +1,101 @@
+#ifndef FLIGHTRECORDER_H
+#define FLIGHTRECORDER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../databases/ResourcesDB.h"
+
+struct lua_State;
+
+// Keeps the last few seconds of per-frame metrics in a fixed ring, always on
+// When a frame runs over frame_budget_ms the frames around it are written to
+// flight_recorder/spike_<frame>.json once flight_recorder_post_frames more frames have run
+class FlightRecorder
+{
+public:
+	enum Phase { LOAD_SCENE, INPUT, UPDATE, RENDER, LATE_UPDATE, PHASE_COUNT };
+
+	struct Record {
+		int frame;
+		float frameMs;
+		float phaseMs[PHASE_COUNT];
+		int actors;
+		int actorsToAdd;
+		int actorsToDestroy;
+		// Render requests of the frame presented, before culling
+		int queuedImages;
+		int queuedText;
+		int queuedPixels;
+		int drawCalls;
+		int luaHeapKb;
+		// Lua collection cycles completed during the frame
+		int gcCycles;
+		bool sceneLoading;
+	};
+
+	// Times one phase of the current frame, phases run on the simulation thread while pipelined
+	class Scope
+	{
+	public:
+		explicit Scope(Phase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+		~Scope() {
+			const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			state().current.phaseMs[phase] += elapsed.count();
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		Phase phase;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	static void init(const ResourcesDB& configDB);
+
+	// Commits the frame that just ended, the simulation thread must be idle
+	static void endFrame(int frame, float frameMs);
+
+	// The frame committed last
+	static const Record& latest();
+
+	// Writes the pending window early, used at exit
+	static void flush();
+
+private:
+	friend class EngineContext;
+
+	struct State {
+		std::vector<Record> ring = {};
+		size_t next = 0;
+		size_t count = 0;
+		Record current = {};
+
+		// 0 disables dumps, frames are still recorded
+		float budgetMs = 0.0f;
+		int postFrames = 60;
+		int maxDumps = 16;
+		std::string dumpDirectory = "flight_recorder";
+
+		// A spike is waiting for the frames after it, later spikes land in the same dump
+		int spikeFrame = -1;
+		float spikeMs = 0.0f;
+		int framesUntilDump = 0;
+		int dumps = 0;
+
+		int gcCycles = 0;
+		int gcCyclesCommitted = 0;
+	};
+
+	static State& state();
+
+	static void dump();
+
+	// A finalizer-only userdata that re-arms itself, counts full collection cycles
+	static void armGcSentinel(lua_State* L);
+	static int onGarbageCollected(lua_State* L);
+};
+
+#endif
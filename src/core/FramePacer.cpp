@@ -0,0 +1,195 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "lua.hpp"
+#include "LuaBridge/LuaBridge.h"
+#include "EngineContext.h"
+#include "../actors/ComponentManager.h"
+#include "../utils/Logger.h"
+
+namespace {
+	// Idle tasks that can't do a useful amount of work in less are not worth the risk of running over
+	constexpr double minIdleBudgetMs = 1.0;
+}
+
+void FramePacer::init(const ResourcesDB& configDB, SDL_Renderer* renderer) {
+	luabridge::getGlobalNamespace(ComponentManager::getLuaState())
+		.beginNamespace("Debug")
+		.addFunction("GetFrameJitter", &FramePacer::getJitterMs)
+		.addFunction("GetMissedFrames", &FramePacer::getMissedFrames)
+		.endNamespace();
+
+	// The pacer holds Helper's present, extra instances are headless and have nothing to pace
+	if (!EngineContext::current().isPrimary() || Helper::IsAutograderMode() || Helper::uncapped_frame_rate) {
+		return;
+	}
+
+	// 0 or less leaves the rate to vsync, or uncapped without it
+	const float targetFps = configDB.mainDoc.getFloat("target_fps", 60.0f);
+	sleeping = targetFps > 0.0f;
+	if (sleeping) {
+		period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps));
+	}
+
+	SDL_RendererInfo info{};
+	const bool vsync = renderer != nullptr && SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+	int refreshRate = 0;
+	if (vsync) {
+		SDL_Window* window = SDL_RenderGetWindow(renderer);
+		const int display = window != nullptr ? std::max(SDL_GetWindowDisplayIndex(window), 0) : 0;
+		SDL_DisplayMode mode{};
+		if (SDL_GetCurrentDisplayMode(display, &mode) == 0) {
+			refreshRate = mode.refresh_rate;
+		}
+	}
+
+	if (vsync && refreshRate > 0 && sleeping) {
+		const int intervals = static_cast<int>(std::lround(refreshRate / targetFps));
+		if (intervals <= 1) {
+			sleeping = false;
+		}
+		else {
+			const std::chrono::duration<double> refreshInterval(1.0 / refreshRate);
+			period = std::chrono::duration_cast<Clock::duration>(refreshInterval * intervals);
+			wakeEarly = std::chrono::duration_cast<Clock::duration>(refreshInterval / 2);
+		}
+	}
+
+	active = true;
+	Helper::frame_pacer = &FramePacer::pace;
+	Logger::debug(Logger::Engine, "frame pacer: target ", targetFps, " fps, vsync ", vsync ? "on" : "off",
+		", refresh ", refreshRate, " Hz, ", sleeping ? "pacing" : "measuring only");
+}
+
+void FramePacer::addIdleTask(IdleTask task) {
+	idleTasks.push_back(task);
+}
+
+void FramePacer::pace() {
+	const Clock::time_point now = Clock::now();
+	if (!started) {
+		started = true;
+		frameStart = now;
+		deadline = now + period;
+		return;
+	}
+
+	if (sleeping) {
+		if (now < deadline) {
+			waitUntil(deadline);
+		}
+		else {
+			if (now - deadline > period / 10) {
+				missed++;
+			}
+			// Too far behind to catch up, the next frame gets a whole period from here
+			if (now - deadline > period) {
+				deadline = now;
+			}
+		}
+		deadline += period;
+	}
+
+	const Clock::time_point end = Clock::now();
+	addFrame(std::chrono::duration<double, std::milli>(end - frameStart).count());
+	frameStart = end;
+}
+
+void FramePacer::waitUntil(Clock::time_point until) {
+	until -= wakeEarly;
+	runIdleTasks(until);
+
+	while (true) {
+		const double remainingNs = std::chrono::duration<double, std::nano>(until - Clock::now()).count();
+		if (remainingNs <= 0.0) {
+			return;
+		}
+		if (remainingNs <= sleepEstimateNs) {
+			break;
+		}
+		sleepSlice();
+	}
+
+	// Under a slice's worst case left, the scheduler can't be trusted with it
+	while (Clock::now() < until) {
+	}
+}
+
+bool FramePacer::runIdleTasks(Clock::time_point until) {
+	bool ran = false;
+	for (IdleTask task : idleTasks) {
+		while (true) {
+			const Clock::time_point start = Clock::now();
+			// Leave the sleep estimate for the wait, a task can overrun by a little
+			const double budgetMs = std::chrono::duration<double, std::milli>(until - start).count() - sleepEstimateNs / 1.0e6;
+			if (budgetMs < minIdleBudgetMs) {
+				return ran;
+			}
+			const bool more = task(budgetMs);
+			idleMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			ran = true;
+			if (!more) {
+				break;
+			}
+		}
+	}
+	return ran;
+}
+
+void FramePacer::sleepSlice() {
+	const Clock::time_point start = Clock::now();
+	// SDL asks the OS for 1ms timer resolution on Windows, elsewhere this is close to exact already
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	const double sleptNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+	sleepCount += 1.0;
+	const double delta = sleptNs - sleepMeanNs;
+	sleepMeanNs += delta / sleepCount;
+	sleepM2 += delta * (sleptNs - sleepMeanNs);
+	const double stdDevNs = sleepCount > 1.0 ? std::sqrt(sleepM2 / (sleepCount - 1.0)) : 0.0;
+	sleepEstimateNs = sleepMeanNs + stdDevNs;
+}
+
+void FramePacer::addFrame(double ms) {
+	frameCount++;
+	if (frameCount == 1) {
+		frameMinMs = frameMaxMs = ms;
+	}
+	frameMinMs = std::min(frameMinMs, ms);
+	frameMaxMs = std::max(frameMaxMs, ms);
+	const double delta = ms - frameMeanMs;
+	frameMeanMs += delta / static_cast<double>(frameCount);
+	frameM2 += delta * (ms - frameMeanMs);
+	const double stdDevMs = frameCount > 1 ? std::sqrt(frameM2 / static_cast<double>(frameCount - 1)) : 0.0;
+	publishedJitterMs.store(static_cast<float>(stdDevMs), std::memory_order_relaxed);
+	publishedMissed.store(static_cast<int>(missed), std::memory_order_relaxed);
+}
+
+FramePacer::Stats FramePacer::getStats() {
+	Stats stats{};
+	stats.frames = frameCount;
+	stats.meanMs = frameMeanMs;
+	stats.stdDevMs = frameCount > 1 ? std::sqrt(frameM2 / static_cast<double>(frameCount - 1)) : 0.0;
+	stats.minMs = frameMinMs;
+	stats.maxMs = frameMaxMs;
+	stats.missed = missed;
+	stats.idleMs = idleMs;
+	return stats;
+}
+
+float FramePacer::getJitterMs() {
+	if (!EngineContext::current().isPrimary()) {
+		return 0.0f;
+	}
+	return publishedJitterMs.load(std::memory_order_relaxed);
+}
+
+int FramePacer::getMissedFrames() {
+	if (!EngineContext::current().isPrimary()) {
+		return 0;
+	}
+	return publishedMissed.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,95 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "SDL2/SDL.h"
+#include "../databases/ResourcesDB.h"
+
+// Holds a play session to target_fps in place of Helper's millisecond SDL_Delay
+// Frames are scheduled against a nanosecond steady clock deadline: the pacer sleeps in 1ms slices while the time left
+// is above what a slice has been seen to overshoot, then spins out the rest, so frames end on time instead of up to a
+// millisecond late. A frame that runs more than a whole period late moves the schedule rather than rushing the next ones.
+// When vsync already holds presents at or under the target the pacer only measures, sleeping on top of it would halve the
+// rate; with a lower target the period is rounded to whole refresh intervals and the wait ends half an interval early.
+// Idle tasks get the slack before the sleep, so a Lua GC step or a few streamed-in actors cost nothing on a fast frame.
+// Off in the autograder and headless runs, those go as fast as they can.
+class FramePacer
+{
+public:
+	// Returns whether there's more to do, budgetMs is what's left before the pacer has to start sleeping
+	using IdleTask = bool (*)(double budgetMs);
+
+	struct Stats {
+		size_t frames;
+		double meanMs;
+		double stdDevMs;
+		double minMs;
+		double maxMs;
+		// Frames that ended later than their deadline plus a tenth of the period
+		size_t missed;
+		// Time handed to idle tasks
+		double idleMs;
+	};
+
+	// After the renderer exists, vsync is read back from it
+	static void init(const ResourcesDB& configDB, SDL_Renderer* renderer);
+
+	static bool isActive() { return active; }
+
+	// Runs in order while they have budget, one that returns false is skipped until the next frame
+	static void addIdleTask(IdleTask task);
+
+	// Helper::frame_pacer, right after the present
+	static void pace();
+
+	static Stats getStats();
+	// Debug.GetFrameJitter: standard deviation of the frame time in ms
+	static float getJitterMs();
+	// Debug.GetMissedFrames
+	static int getMissedFrames();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	static inline bool active = false;
+	static inline Clock::duration period = {};
+	// Pace even with vsync on, the target is below the refresh rate
+	static inline bool sleeping = true;
+	// Wake this much before the deadline, half a refresh interval with vsync so the present makes the intended vblank
+	static inline Clock::duration wakeEarly = {};
+	static inline Clock::time_point deadline = {};
+	static inline Clock::time_point frameStart = {};
+	static inline bool started = false;
+
+	// Running mean and variance of what a 1ms sleep really takes (Welford)
+	static inline double sleepCount = 0.0;
+	static inline double sleepMeanNs = 0.0;
+	static inline double sleepM2 = 0.0;
+	// Time left under which the pacer spins instead of sleeping
+	static inline double sleepEstimateNs = 2.0e6;
+
+	// Frame times (Welford)
+	static inline size_t frameCount = 0;
+	static inline double frameMeanMs = 0.0;
+	static inline double frameM2 = 0.0;
+	static inline double frameMinMs = 0.0;
+	static inline double frameMaxMs = 0.0;
+	static inline size_t missed = 0;
+	static inline double idleMs = 0.0;
+	// What Lua reads, published by addFrame: with pipelined rendering scripts run on the simulation thread while pace() runs in the present
+	static inline std::atomic<float> publishedJitterMs{ 0.0f };
+	static inline std::atomic<int> publishedMissed{ 0 };
+
+	static inline std::vector<IdleTask> idleTasks = {};
+
+	static void waitUntil(Clock::time_point until);
+	static bool runIdleTasks(Clock::time_point until);
+	static void sleepSlice();
+	static void addFrame(double ms);
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "FramePipeline.h"
+
+#include <cstdlib>
+
+#include "../utils/Profiler.h"
+
+void FramePipeline::start(void (*simulate)()) {
+	if (isRunning()) {
+		return;
+	}
+	if (sync == nullptr) {
+		sync = new Sync();
+		// Lua can exit() on either thread mid-frame, see onExit
+		std::atexit(&FramePipeline::onExit);
+	}
+	FramePipeline::simulate = simulate;
+	simulationRequested = false;
+	simulating = false;
+	stopping = false;
+	finished = false;
+
+	// Detached so exit() never finds a joinable std::thread, stop() waits on finished instead
+	std::thread thread(&FramePipeline::run);
+	simulationThread = thread.get_id();
+	thread.detach();
+}
+
+void FramePipeline::stop() {
+	if (!isRunning()) {
+		return;
+	}
+	std::unique_lock<std::mutex> lock(sync->mutex);
+	stopping = true;
+	sync->wake.notify_one();
+	sync->done.wait(lock, [] { return finished; });
+}
+
+bool FramePipeline::isRunning() {
+	return sync != nullptr && !finished;
+}
+
+void FramePipeline::beginSimulation() {
+	const std::lock_guard<std::mutex> lock(sync->mutex);
+	simulationRequested = true;
+	sync->wake.notify_one();
+}
+
+void FramePipeline::waitForSimulation() {
+	PROFILE_ZONE("FramePipeline::waitForSimulation");
+	std::unique_lock<std::mutex> lock(sync->mutex);
+	mainWaiting = true;
+	sync->done.notify_all();
+	sync->done.wait(lock, [] { return !simulationRequested && !simulating; });
+	mainWaiting = false;
+}
+
+void FramePipeline::run() {
+	PROFILE_THREAD("simulation");
+	std::unique_lock<std::mutex> lock(sync->mutex);
+	while (true) {
+		sync->wake.wait(lock, [] { return simulationRequested || stopping; });
+		if (stopping) {
+			break;
+		}
+		simulationRequested = false;
+		simulating = true;
+		lock.unlock();
+
+		simulate();
+
+		lock.lock();
+		simulating = false;
+		sync->done.notify_all();
+	}
+	finished = true;
+	sync->done.notify_all();
+}
+
+void FramePipeline::onExit() {
+	if (!isRunning()) {
+		return;
+	}
+	if (std::this_thread::get_id() != simulationThread) {
+		// Let the simulation finish its frame, it must not run Lua while statics are torn down
+		stop();
+		return;
+	}
+	// Exiting from Lua: wait for the main thread to finish rendering and park in waitForSimulation
+	std::unique_lock<std::mutex> lock(sync->mutex);
+	sync->done.wait(lock, [] { return mainWaiting; });
+}
@@ -0,0 +1,45 @@
+#ifndef FRAMEPIPELINE_H
+#define FRAMEPIPELINE_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Runs the Lua simulation of frame N+1 on its own thread while the main thread renders frame N
+// SDL stays on the main thread, the two meet once per frame in waitForSimulation where the
+// Renderer swaps its double-buffered render queues
+class FramePipeline
+{
+public:
+	// simulate is called on the simulation thread once per beginSimulation
+	static void start(void (*simulate)());
+	static void stop();
+	static bool isRunning();
+
+	static void beginSimulation();
+	// Blocks until the frame started by beginSimulation is fully simulated
+	static void waitForSimulation();
+
+private:
+	// Never destroyed, a thread can still be waiting on them while exit() runs static destructors
+	struct Sync {
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+	};
+	static inline Sync* sync = nullptr;
+	static inline void (*simulate)() = nullptr;
+	static inline std::thread::id simulationThread;
+
+	// All guarded by sync->mutex
+	static inline bool simulationRequested = false;
+	static inline bool simulating = false;
+	static inline bool mainWaiting = false;
+	static inline bool stopping = false;
+	static inline bool finished = true;
+
+	static void run();
+	static void onExit();
+};
+
+#endif
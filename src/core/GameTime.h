@@ -0,0 +1,50 @@
+#ifndef GAMETIME_H
+#define GAMETIME_H
+
+#include <chrono>
+
+#include "../databases/ResourcesDB.h"
+
+// Frame timing for the Time namespace and the optional fixed simulation rate
+// With fixed_timestep_hz set, updates run at that rate whatever the render rate is: a rendered frame runs as many
+// steps as the time it took covers (zero when rendering faster than the simulation, the last simulated frame
+// is drawn again) and at most fixed_timestep_max_steps, time past that is dropped so a slow frame can't snowball.
+// Time.Alpha is how far the clock is between the last step and the next one, for OnRender to interpolate with.
+class GameTime
+{
+public:
+	// The fixed rate is off in autograder mode, replayed input is tied to the rendered frame
+	static void init(const ResourcesDB& configDB);
+
+	static bool isFixed() { return state().stepSeconds > 0.0; }
+
+	// Once per rendered frame, returns how many updates to run: always 1 without a fixed rate
+	static int beginFrame();
+	// Around each fixed step, Time.DeltaTime reads the step inside it
+	static void beginStep() { state().inStep = true; }
+	static void endStep() { state().inStep = false; }
+
+	// Time.DeltaTime: seconds covered by this update, the step inside a fixed step and the rendered frame otherwise
+	static float getDeltaTime();
+	// Time.FixedDeltaTime: the step, or the rendered frame without a fixed rate
+	static float getFixedDeltaTime();
+	// Time.Alpha: [0, 1) between the last two steps, 1 without a fixed rate
+	static float getAlpha();
+
+private:
+	friend class EngineContext;
+
+	struct State {
+		double stepSeconds = 0.0;
+		int maxSteps = 5;
+		double accumulator = 0.0;
+		double frameSeconds = 0.0;
+		bool inStep = false;
+		bool started = false;
+		std::chrono::steady_clock::time_point lastFrame = {};
+	};
+
+	static State& state();
+};
+
+#endif
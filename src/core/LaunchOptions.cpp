@@ -0,0 +1,40 @@
+#include "LaunchOptions.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include "../../external_helpers/Helper.h"
+#include "../utils/Logger.h"
+
+LaunchOptions LaunchOptions::parse(int argc, char* argv[]) {
+	LaunchOptions options;
+	for (int i = 1; i < argc; i++) {
+		const std::string argument = argv[i];
+		if (argument == "--headless") {
+			options.headless = true;
+		}
+		else if (argument == "--frames" && i + 1 < argc) {
+			options.frames = std::max(std::atoi(argv[++i]), 0);
+		}
+		else if (argument == "--until-scene" && i + 1 < argc) {
+			options.untilScene = argv[++i];
+		}
+		else if (argument == "--scene" && i + 1 < argc) {
+			options.scene = argv[++i];
+		}
+		else if (argument == "--instances" && i + 1 < argc) {
+			options.instances = std::max(std::atoi(argv[++i]), 1);
+		}
+		else {
+			Logger::warning(Logger::Engine, "ignoring unknown option ", argument);
+		}
+	}
+	// The extra instances have no window, audio or input, and Helper's replay, capture and render logger only follow one game
+	if (options.instances > 1) {
+		Helper::CheckForRenderLoggerInit();
+		if (!options.headless || Helper::IsAutograderMode() || Helper::render_logger_mode == RL_ENABLED) {
+			Logger::warning(Logger::Engine, "--instances needs --headless outside autograder and render logger runs, running one instance");
+			options.instances = 1;
+		}
+	}
+	return options;
+}
@@ -0,0 +1,24 @@
+#ifndef LAUNCHOPTIONS_H
+#define LAUNCHOPTIONS_H
+
+#include <string>
+
+// Command line options that change how the game loop runs, the --pack style tools are handled in main
+struct LaunchOptions {
+	// --headless: dummy video/audio drivers, an offscreen software render target, no vsync and no frame delay
+	bool headless = false;
+	// --frames N: stop after N frames, 0 runs until the game quits
+	int frames = 0;
+	// --until-scene NAME: stop at the end of the first frame NAME is the current scene
+	std::string untilScene = "";
+	// --scene NAME: start in NAME instead of the configured initial_scene
+	std::string scene = "";
+	// Headless runs print a throughput report at the end, tools that own stdout like the micro-benchmarks turn it off
+	bool frameReport = true;
+	// --instances N: run N copies of the game side by side in this process, headless only and never pipelined, see EngineContext
+	int instances = 1;
+
+	static LaunchOptions parse(int argc, char* argv[]);
+};
+
+#endif
@@ -0,0 +1,138 @@
+#include "MemoryStats.h"
+
+#include <iostream>
+#include <sstream>
+
+#include "EngineContext.h"
+#include "FramePipeline.h"
+#include "../databases/AudioDB.h"
+#include "../rendering/FontDB.h"
+#include "../rendering/GlyphAtlas.h"
+#include "../rendering/PixelBuffer.h"
+#include "../rendering/Renderer.h"
+#include "../rendering/TextureAtlas.h"
+#include "../utils/Logger.h"
+
+size_t MemoryStats::Report::totalBytes() const {
+	return textureBytes + textCacheBytes + glyphBytes + pixelBufferBytes + audioBytes + jsonBytes + luaHeapBytes;
+}
+
+void MemoryStats::init(const ResourcesDB& resources, const std::unique_ptr<Scene>& currentScene, bool headless) {
+	State& s = state();
+	s.resources = &resources;
+	s.currentScene = &currentScene;
+	s.reportInterval = headless ? resources.mainDoc.getInt("memory_report_interval", 600) : 0;
+	s.snapshot = collect();
+
+	luabridge::getGlobalNamespace(ComponentManager::getLuaState())
+		.beginNamespace("Debug")
+		.addFunction("GetMemoryStats", &MemoryStats::getStatsTable)
+		.addFunction("DumpMemoryStats", &MemoryStats::dumpStats)
+		.endNamespace();
+}
+
+MemoryStats::Report MemoryStats::collect() {
+	State& s = state();
+	Report report{};
+	report.frame = EngineContext::getFrameNumber();
+	report.textures = static_cast<size_t>(TextureAtlas::getTextureCount());
+	report.textureBytes = TextureAtlas::getTextureBytes();
+	report.textCacheEntries = Renderer::getTextCacheCount();
+	report.textCacheBytes = Renderer::getTextCacheBytes();
+	report.glyphPages = static_cast<size_t>(GlyphAtlas::getPageCount());
+	report.glyphBytes = GlyphAtlas::getTextureBytes();
+	report.pixelBufferBytes = PixelBuffer::getMemoryBytes();
+	report.audioClips = AudioDB::getClipCount();
+	report.audioBytes = AudioDB::getPcmBytes();
+	report.fonts = FontDB::getFontCount();
+
+	report.jsonBytes = s.resources != nullptr ? s.resources->getMemoryBytes() : 0;
+	if (s.currentScene != nullptr && *s.currentScene != nullptr) {
+		report.jsonBytes += (*s.currentScene)->getSceneDB().mainDoc.getMemoryBytes();
+	}
+
+	lua_State* L = ComponentManager::getLuaState();
+	report.luaHeapBytes = static_cast<size_t>(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + static_cast<size_t>(lua_gc(L, LUA_GCCOUNTB, 0));
+
+	report.actors = ActorsGuild::getMembers().size() + ActorsGuild::getActorsToAdd().size();
+	for (const auto& actors : { &ActorsGuild::getMembers(), &ActorsGuild::getActorsToAdd() }) {
+		for (const auto& actor : *actors) {
+			report.components += actor->components.size() + actor->justAddedComponents.size();
+		}
+	}
+	return report;
+}
+
+void MemoryStats::dump(std::ostream& os, const Report& report) {
+	// "key: value" lines like the headless frame report, benchmarks/stress/run.py parses both
+	os << "memory frame: " << report.frame << '\n'
+		<< "memory textures: " << report.textures << '\n'
+		<< "memory textures kb: " << report.textureBytes / 1024 << '\n'
+		<< "memory text cache entries: " << report.textCacheEntries << '\n'
+		<< "memory text cache kb: " << report.textCacheBytes / 1024 << '\n'
+		<< "memory glyph pages: " << report.glyphPages << '\n'
+		<< "memory glyph kb: " << report.glyphBytes / 1024 << '\n'
+		<< "memory pixel buffer kb: " << report.pixelBufferBytes / 1024 << '\n'
+		<< "memory audio clips: " << report.audioClips << '\n'
+		<< "memory audio kb: " << report.audioBytes / 1024 << '\n'
+		<< "memory fonts: " << report.fonts << '\n'
+		<< "memory json kb: " << report.jsonBytes / 1024 << '\n'
+		<< "memory lua heap kb: " << report.luaHeapBytes / 1024 << '\n'
+		<< "memory actors: " << report.actors << '\n'
+		<< "memory components: " << report.components << '\n'
+		<< "memory total kb: " << report.totalBytes() / 1024 << '\n';
+}
+
+void MemoryStats::endFrame(int framesRun) {
+	State& s = state();
+	const bool periodic = s.reportInterval > 0 && framesRun % s.reportInterval == 0;
+	if (s.snapshotRequested || periodic) {
+		s.snapshot = collect();
+		s.snapshotRequested = false;
+	}
+	if (periodic) {
+		std::ostringstream report;
+		dump(report, s.snapshot);
+		Logger::output(Logger::Engine, report.str());
+	}
+}
+
+const MemoryStats::Report& MemoryStats::current() {
+	State& s = state();
+	// Lua runs on the simulation thread while the main thread renders into the caches, only the primary instance pipelines
+	if (FramePipeline::isRunning() && EngineContext::current().isPrimary()) {
+		s.snapshotRequested = true;
+	}
+	else {
+		s.snapshot = collect();
+	}
+	return s.snapshot;
+}
+
+luabridge::LuaRef MemoryStats::getStatsTable() {
+	const Report& report = current();
+	luabridge::LuaRef table = luabridge::newTable(ComponentManager::getLuaState());
+	table["frame"] = report.frame;
+	table["textures"] = static_cast<double>(report.textures);
+	table["texture_bytes"] = static_cast<double>(report.textureBytes);
+	table["text_cache_entries"] = static_cast<double>(report.textCacheEntries);
+	table["text_cache_bytes"] = static_cast<double>(report.textCacheBytes);
+	table["glyph_pages"] = static_cast<double>(report.glyphPages);
+	table["glyph_bytes"] = static_cast<double>(report.glyphBytes);
+	table["pixel_buffer_bytes"] = static_cast<double>(report.pixelBufferBytes);
+	table["audio_clips"] = static_cast<double>(report.audioClips);
+	table["audio_bytes"] = static_cast<double>(report.audioBytes);
+	table["fonts"] = static_cast<double>(report.fonts);
+	table["json_bytes"] = static_cast<double>(report.jsonBytes);
+	table["lua_heap_bytes"] = static_cast<double>(report.luaHeapBytes);
+	table["actors"] = static_cast<double>(report.actors);
+	table["components"] = static_cast<double>(report.components);
+	table["total_bytes"] = static_cast<double>(report.totalBytes());
+	return table;
+}
+
+void MemoryStats::dumpStats() {
+	std::ostringstream report;
+	dump(report, current());
+	Logger::output(Logger::Engine, report.str());
+}
@@ -0,0 +1,69 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+
+#include "Scene.h"
+
+// Where the engine's memory sits, cache by cache
+// Texture sizes are estimates at 4 bytes per pixel, GPU drivers may hold more
+class MemoryStats
+{
+public:
+	struct Report {
+		int frame;
+		size_t textures;
+		size_t textureBytes;
+		size_t textCacheEntries;
+		size_t textCacheBytes;
+		size_t glyphPages;
+		size_t glyphBytes;
+		size_t pixelBufferBytes;
+		size_t audioClips;
+		size_t audioBytes;
+		size_t fonts;
+		// Config, templates and the current scene
+		size_t jsonBytes;
+		size_t luaHeapBytes;
+		size_t actors;
+		size_t components;
+
+		size_t totalBytes() const;
+	};
+
+	// The Engine's config and scene aren't reachable from here otherwise
+	static void init(const ResourcesDB& resources, const std::unique_ptr<Scene>& currentScene, bool headless);
+
+	// Reads every cache, main thread only while pipelined
+	static Report collect();
+	static void dump(std::ostream& os, const Report& report);
+
+	// Once per frame on the main thread with the simulation idle
+	static void endFrame(int framesRun);
+
+	// Debug.GetMemoryStats and Debug.DumpMemoryStats
+	// While pipelined Lua gets the numbers of the last frame boundary, asking refreshes them at the next one
+	static luabridge::LuaRef getStatsTable();
+	static void dumpStats();
+
+private:
+	friend class EngineContext;
+
+	struct State {
+		const ResourcesDB* resources = nullptr;
+		const std::unique_ptr<Scene>* currentScene = nullptr;
+
+		Report snapshot = {};
+		bool snapshotRequested = false;
+		// Headless runs print a report every this many frames, 0 never
+		int reportInterval = 0;
+	};
+
+	static State& state();
+
+	static const Report& current();
+};
+
+#endif
@@ -18,8 +18,15 @@ public:
 		ActorsGuild::loadActors(sceneDB);
 	}
 
+	// Only parses the scene file, actors are built afterwards by the SceneLoader
+	explicit Scene(const std::string& sceneName) : sceneName(sceneName), sceneDB(sceneName) {
+		sceneDB.loadData();
+	}
+
 	std::string getSceneName() const { return sceneName; }
 
+	const SceneDB& getSceneDB() const { return sceneDB; }
+
 private:
 	std::string sceneName;
 	SceneDB sceneDB;
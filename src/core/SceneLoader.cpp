@@ -0,0 +1,137 @@
+#include "SceneLoader.h"
+
+#include <chrono>
+#include <cstdlib>
+#include "EngineContext.h"
+#include "../utils/Logger.h"
+
+void SceneLoader::init(const ResourcesDB& configDB) {
+	state().budgetMs = configDB.mainDoc.getFloat("scene_load_budget_ms", 4.0f);
+
+	// Lua can exit() mid-load, a still joinable std::thread would terminate the process on destruction
+	// Other instances cancel their load on shutdown instead
+	if (EngineContext::current().isPrimary()) {
+		std::atexit(&SceneLoader::joinWorker);
+	}
+}
+
+void SceneLoader::loadAsync(const std::string& name) {
+	State& s = state();
+	if (s.phase != Phase::IDLE && name == s.sceneName) {
+		return;
+	}
+	cancel();
+
+	// Report a missing scene right away instead of from the worker thread
+	if (!SceneDB::exists(name)) {
+		Logger::fatal("error: scene " + name + " is missing");
+	}
+
+	s.sceneName = name;
+	s.phase = Phase::PARSING;
+	s.worker = std::thread([context = &EngineContext::current()] {
+		const EngineContext::Bind bind(*context);
+		parseScene();
+	});
+}
+
+void SceneLoader::cancel() {
+	State& s = state();
+	joinWorker();
+	s.pendingScene.reset();
+	s.actorsData.clear();
+	s.builtActors.clear();
+	s.nextActorIndex = 0;
+	s.sceneName = "";
+	s.phase = Phase::IDLE;
+}
+
+void SceneLoader::parseScene() {
+	State& s = state();
+	// Worker thread: json parsing and copying actor data only, Lua is never touched here
+	s.pendingScene = std::make_unique<Scene>(s.sceneName);
+	s.actorsData = ActorsGuild::prepareActors(s.pendingScene->getSceneDB());
+	s.phase.store(Phase::BUILDING, std::memory_order_release);
+}
+
+void SceneLoader::update() {
+	build(state().budgetMs);
+}
+
+bool SceneLoader::idleUpdate(double allowedMs) {
+	build(allowedMs);
+	return state().phase.load(std::memory_order_acquire) == Phase::BUILDING;
+}
+
+void SceneLoader::build(double allowedMs) {
+	State& s = state();
+	if (s.phase.load(std::memory_order_acquire) != Phase::BUILDING) {
+		return;
+	}
+	joinWorker();
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto budget = std::chrono::duration<double, std::milli>(allowedMs);
+	s.builtActors.reserve(s.actorsData.size());
+
+	// Always build at least one actor so a tiny budget still makes progress
+	do {
+		if (s.nextActorIndex >= s.actorsData.size()) {
+			break;
+		}
+		s.builtActors.push_back(ActorsGuild::buildActor(s.actorsData[s.nextActorIndex++]));
+	} while (std::chrono::steady_clock::now() - start < budget);
+
+	if (s.nextActorIndex >= s.actorsData.size()) {
+		s.actorsData.clear();
+		s.phase = Phase::READY;
+	}
+}
+
+bool SceneLoader::isReadyToSwap() {
+	return state().phase == Phase::READY;
+}
+
+std::unique_ptr<Scene> SceneLoader::takeScene() {
+	State& s = state();
+	ActorsGuild::adoptActors(s.builtActors);
+	std::unique_ptr<Scene> scene = std::move(s.pendingScene);
+	s.nextActorIndex = 0;
+	s.sceneName = "";
+	s.phase = Phase::IDLE;
+	return scene;
+}
+
+bool SceneLoader::isLoading() {
+	return state().phase != Phase::IDLE;
+}
+
+float SceneLoader::getProgress() {
+	State& s = state();
+	switch (s.phase.load(std::memory_order_acquire)) {
+	case Phase::IDLE:
+	case Phase::READY:
+		return 1.0f;
+	case Phase::PARSING:
+		return 0.0f;
+	case Phase::BUILDING:
+		return s.actorsData.empty() ? 1.0f : static_cast<float>(s.nextActorIndex) / static_cast<float>(s.actorsData.size());
+	}
+	return 0.0f;
+}
+
+void SceneLoader::joinWorker() {
+	State& s = state();
+	if (!s.worker.joinable()) {
+		return;
+	}
+	// A json error exits from inside the worker, it can't join itself and a joinable
+	// std::thread left for the static destructors would call std::terminate
+	if (s.worker.get_id() == std::this_thread::get_id()) {
+		s.worker.detach();
+		return;
+	}
+	s.joining = true;
+	s.worker.join();
+	s.joining = false;
+}
@@ -0,0 +1,70 @@
+#ifndef SCENELOADER_H
+#define SCENELOADER_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Scene.h"
+
+// Loads a scene in the background while the current one keeps running
+// The scene file is parsed on a worker thread, actors are then built on the main thread
+// a few at a time each frame, and the Engine swaps scenes once everything is built
+class SceneLoader
+{
+public:
+	static void init(const ResourcesDB& configDB);
+
+	// Scene.LoadAsync
+	static void loadAsync(const std::string& sceneName);
+	// Drops any in-flight load, used when a blocking Scene.Load wins the race
+	static void cancel();
+
+	// Builds actors until the frame's time budget is used up, call once per frame
+	static void update();
+	// FramePacer idle task, builds ahead into the frame's slack and returns whether actors are left
+	static bool idleUpdate(double allowedMs);
+
+	// Scene is fully built and waiting for the next frame boundary
+	static bool isReadyToSwap();
+	// Hands the built scene over, actors are moved into the ActorsGuild
+	static std::unique_ptr<Scene> takeScene();
+
+	// Scene.IsLoading
+	static bool isLoading();
+	// Scene.GetLoadProgress, fraction of actors built [0, 1]
+	static float getProgress();
+
+	static std::string getLoadingSceneName() { return state().sceneName; }
+
+	// The instance's loop is blocked joining the worker, see Engine::onFatalError
+	static bool isJoiningWorker() { return state().joining; }
+
+private:
+	enum class Phase { IDLE, PARSING, BUILDING, READY };
+
+	friend class EngineContext;
+
+	struct State {
+		std::atomic<Phase> phase = Phase::IDLE;
+		std::thread worker;
+		std::atomic<bool> joining = false;
+		float budgetMs = 4.0f;
+
+		std::string sceneName = "";
+		std::unique_ptr<Scene> pendingScene = nullptr;
+		std::vector<Datadoc> actorsData = {};
+		std::vector<std::shared_ptr<Actor>> builtActors = {};
+		size_t nextActorIndex = 0;
+	};
+
+	static State& state();
+
+	static void parseScene();
+	static void build(double allowedMs);
+	static void joinWorker();
+};
+
+#endif
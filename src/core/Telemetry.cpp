@@ -0,0 +1,63 @@
+#include "Telemetry.h"
+
+#include <chrono>
+#include <filesystem>
+#include <new>
+
+#include "../rendering/RenderStats.h"
+#include "../utils/AllocationTracker.h"
+#include "../utils/Logger.h"
+
+void Telemetry::init(const ResourcesDB& configDB) {
+	if (!configDB.mainDoc.getBool("telemetry", false)) {
+		return;
+	}
+	std::error_code error;
+	const std::filesystem::path shared = "/dev/shm";
+	const std::filesystem::path fallback = (std::filesystem::is_directory(shared, error) ? shared : std::filesystem::temp_directory_path(error)) / "ko_telemetry";
+	const std::string path = configDB.mainDoc.getString("telemetry_path", fallback.string());
+
+	if (!file.openReadWrite(path, sizeof(TelemetryLayout::Block))) {
+		Logger::warning(Logger::Engine, "telemetry: failed to map ", path);
+		return;
+	}
+	// Zeroes the samples too, a reader sees no magic until the header is complete
+	block = new (file.writableData()) TelemetryLayout::Block();
+	block->version = TelemetryLayout::version;
+	block->sampleSize = sizeof(TelemetryLayout::Sample);
+	block->capacity = TelemetryLayout::sampleCapacity;
+	block->flags = AllocationTracker::isEnabled() ? TelemetryLayout::allocationsTracked : 0;
+	std::atomic_thread_fence(std::memory_order_release);
+	block->magic = TelemetryLayout::magic;
+}
+
+void Telemetry::publish(const FlightRecorder::Record& record) {
+	if (block == nullptr) {
+		return;
+	}
+	TelemetryLayout::Sample sample{};
+	sample.frame = record.frame;
+	sample.frameMs = record.frameMs;
+	static_assert(static_cast<int>(TelemetryLayout::PHASE_COUNT) == static_cast<int>(FlightRecorder::PHASE_COUNT), "phases are copied one to one");
+	for (int phase = 0; phase < FlightRecorder::PHASE_COUNT; phase++) {
+		sample.phaseMs[phase] = record.phaseMs[phase];
+	}
+	sample.presentMs = RenderStats::getPresentMs();
+	sample.actors = record.actors;
+	sample.queuedImages = record.queuedImages;
+	sample.queuedText = record.queuedText;
+	sample.queuedPixels = record.queuedPixels;
+	sample.drawCalls = record.drawCalls;
+	sample.luaHeapKb = record.luaHeapKb;
+	sample.gcCycles = record.gcCycles;
+	const AllocationTracker::Counts& allocations = AllocationTracker::getLastFrame();
+	sample.allocations = static_cast<uint32_t>(allocations.totalAllocations());
+	sample.allocatedBytes = allocations.totalBytes();
+
+	const auto now = std::chrono::system_clock::now().time_since_epoch();
+	TelemetryLayout::beginWrite(*block);
+	block->samples[block->written % TelemetryLayout::sampleCapacity] = sample;
+	block->written++;
+	block->updatedMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+	TelemetryLayout::endWrite(*block);
+}
@@ -0,0 +1,24 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "FlightRecorder.h"
+#include "../utils/MappedFile.h"
+#include "../utils/TelemetryLayout.h"
+
+// Publishes live per-frame counters to a memory-mapped file for tools/telemetry_view
+// Off unless "telemetry" is true in game.config, "telemetry_path" overrides where the file goes
+// (/dev/shm/ko_telemetry when /dev/shm exists, the temp directory otherwise)
+class Telemetry
+{
+public:
+	static void init(const ResourcesDB& configDB);
+
+	// Once per frame with the simulation idle, never blocks on readers
+	static void publish(const FlightRecorder::Record& record);
+
+private:
+	static inline MappedFile file;
+	static inline TelemetryLayout::Block* block = nullptr;
+};
+
+#endif
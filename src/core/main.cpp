@@ -1,16 +1,60 @@
 #include "Engine.h"
+#include "../rendering/FrameCapture.h"
+#include "../rendering/FrameChecksum.h"
+#include "../utils/Logger.h"
+
+#include <thread>
+#include <vector>
 
 #include "SDL2/SDL.h"
 #include "SDL2_image/SDL_image.h"
 
 int main(int argc, char* argv[])
 {
+	// First so every console write from here on goes through the logger's writer thread
+	Logger::start();
+
+	// --pack [resources dir] [archive]: bundle resources/ into resources.pak and exit
+	if (argc > 1 && std::string(argv[1]) == "--pack") {
+		const std::string resourcesDir = argc > 2 ? argv[2] : "resources";
+		const std::string archivePath = argc > 3 ? argv[3] : AssetArchive::defaultArchivePath;
+		return AssetArchive::pack(resourcesDir, archivePath) ? 0 : 1;
+	}
+	// --expand-frames [frames dir]: turn "delta" frame captures back into BMPs and exit
+	if (argc > 1 && std::string(argv[1]) == "--expand-frames") {
+		return FrameCapture::expand(argc > 2 ? argv[2] : Helper::frame_directory_relative_path) ? 0 : 1;
+	}
+	// --compare-checksums expected actual: first frame at which two FRAMECHECKSUM logs differ
+	if (argc > 3 && std::string(argv[1]) == "--compare-checksums") {
+		return FrameChecksum::compare(argv[2], argv[3]) ? 0 : 1;
+	}
+
+	// --headless [--frames N] [--until-scene NAME]: benchmark without a display, see LaunchOptions
+	const LaunchOptions options = LaunchOptions::parse(argc, argv);
+	if (options.headless) {
+		// Environment rather than hints, older SDL versions only read the variables
+		SDL_setenv(SDL_HINT_VIDEODRIVER, "dummy", 1);
+		SDL_setenv(SDL_HINT_AUDIODRIVER, "dummy", 1);
+		Helper::uncapped_frame_rate = true;
+	}
+
 	if (SDL_Init(SDL_INIT_EVERYTHING) < 0) {
-		std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << '\n';
+		Logger::error(Logger::Engine, "SDL could not initialize! SDL_Error: ", SDL_GetError());
 	}
 
-	Engine engine;
+	// The primary instance sets up what the process shares before the extra ones start, see EngineContext
+	Engine engine(options);
+	if (options.instances > 1) {
+		Logger::setFatalHandler(&Engine::onFatalError);
+	}
+	std::vector<std::thread> instances;
+	for (int id = 1; id < options.instances; id++) {
+		instances.emplace_back(&Engine::runInstance, options, id);
+	}
 	Engine::gameLoop();
+	for (std::thread& instance : instances) {
+		instance.join();
+	}
 	SDL_Quit();
 	return 0;
 }
@@ -0,0 +1,173 @@
+#include "AssetArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "../utils/Logger.h"
+
+bool AssetArchive::openDefault() {
+    if (open(defaultArchivePath)) {
+        return true;
+    }
+    char* basePath = SDL_GetBasePath();
+    if (basePath == nullptr) {
+        return false;
+    }
+    const fs::path besideExecutable = fs::path(basePath) / defaultArchivePath;
+    SDL_free(basePath);
+    return open(besideExecutable);
+}
+
+bool AssetArchive::open(const fs::path& archivePath) {
+    if (!fs::exists(archivePath) || !file.openReadOnly(archivePath)) {
+        return false;
+    }
+
+    Header header{};
+    if (file.size() < sizeof(Header)) {
+        Logger::fatal("error: ", archivePath.string(), " is corrupt");
+    }
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if (header.magic != magic || header.version != version) {
+        Logger::fatal("error: ", archivePath.string(), " is corrupt");
+    }
+
+    const uint64_t tocSize = static_cast<uint64_t>(header.entryCount) * sizeof(Entry);
+    const uint64_t stringsOffset = sizeof(Header) + tocSize;
+    if (stringsOffset + header.stringTableSize > file.size()) {
+        Logger::fatal("error: ", archivePath.string(), " is corrupt");
+    }
+
+    const char* base = reinterpret_cast<const char*>(file.data());
+    const char* strings = base + stringsOffset;
+    assets.reserve(header.entryCount);
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        Entry entry{};
+        std::memcpy(&entry, file.data() + sizeof(Header) + i * sizeof(Entry), sizeof(Entry));
+        if (static_cast<uint64_t>(entry.pathOffset) + entry.pathLength > header.stringTableSize
+            || entry.dataOffset > file.size() || entry.dataSize > file.size() - entry.dataOffset) {
+            Logger::fatal("error: ", archivePath.string(), " is corrupt");
+        }
+
+        const std::string_view path(strings + entry.pathOffset, entry.pathLength);
+        assets.emplace(path, std::string_view(base + entry.dataOffset, static_cast<size_t>(entry.dataSize)));
+
+        const size_t slash = path.rfind('/');
+        const std::string_view directory = slash == std::string_view::npos ? std::string_view() : path.substr(0, slash);
+        directories[directory].push_back(path);
+    }
+    return true;
+}
+
+bool AssetArchive::isOpen() {
+    return file.isOpen();
+}
+
+std::optional<std::string_view> AssetArchive::find(const std::string& path) {
+    if (const auto it = assets.find(path); it != assets.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+bool AssetArchive::contains(const std::string& path) {
+    return assets.find(path) != assets.end();
+}
+
+SDL_RWops* AssetArchive::openRW(const std::string& path) {
+    const auto data = find(path);
+    if (!data.has_value()) {
+        return nullptr;
+    }
+    return SDL_RWFromConstMem(data->data(), static_cast<int>(data->size()));
+}
+
+std::vector<std::string_view> AssetArchive::list(const std::string& directory, const std::string& extension) {
+    std::vector<std::string_view> result;
+    const auto it = directories.find(directory);
+    if (it == directories.end()) {
+        return result;
+    }
+    for (const auto& path : it->second) {
+        if (path.size() > extension.size() && path.substr(path.size() - extension.size()) == extension) {
+            result.push_back(path);
+        }
+    }
+    return result;
+}
+
+std::string AssetArchive::stem(std::string_view path) {
+    const size_t slash = path.rfind('/');
+    if (slash != std::string_view::npos) {
+        path.remove_prefix(slash + 1);
+    }
+    const size_t dot = path.rfind('.');
+    if (dot != std::string_view::npos && dot != 0) {
+        path = path.substr(0, dot);
+    }
+    return std::string(path);
+}
+
+bool AssetArchive::pack(const fs::path& resourcesDir, const fs::path& archivePath) {
+    if (!fs::is_directory(resourcesDir)) {
+        Logger::output(Logger::Assets, "error: ", resourcesDir.string(), " missing");
+        return false;
+    }
+
+    std::vector<std::pair<std::string, fs::path>> files;
+    for (auto it = fs::recursive_directory_iterator(resourcesDir); it != fs::recursive_directory_iterator(); ++it) {
+        // Decoded-image caches are machine local, they are rebuilt from the packed sources
+        if (it->is_directory() && it->path().filename() == ".cache") {
+            it.disable_recursion_pending();
+            continue;
+        }
+        // Never pack an older archive into the new one
+        if (it->is_regular_file() && it->path().extension() != ".pak") {
+            files.emplace_back(fs::relative(it->path(), resourcesDir).generic_string(), it->path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    Header header{ magic, version, static_cast<uint32_t>(files.size()), 0 };
+    std::vector<Entry> entries(files.size());
+    std::string strings;
+    for (size_t i = 0; i < files.size(); i++) {
+        entries[i].pathOffset = static_cast<uint32_t>(strings.size());
+        entries[i].pathLength = static_cast<uint32_t>(files[i].first.size());
+        strings += files[i].first;
+    }
+    header.stringTableSize = static_cast<uint32_t>(strings.size());
+
+    // Lay the blobs out after the string table, each one aligned
+    uint64_t offset = sizeof(Header) + entries.size() * sizeof(Entry) + strings.size();
+    for (size_t i = 0; i < files.size(); i++) {
+        offset = (offset + blobAlignment - 1) & ~(blobAlignment - 1);
+        entries[i].dataOffset = offset;
+        entries[i].dataSize = fs::file_size(files[i].second);
+        offset += entries[i].dataSize;
+    }
+
+    std::ofstream out(archivePath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        Logger::output(Logger::Assets, "error: failed to write ", archivePath.string());
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+    out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+    static constexpr char padding[blobAlignment] = {};
+    std::vector<char> buffer;
+    for (size_t i = 0; i < files.size(); i++) {
+        const uint64_t position = static_cast<uint64_t>(out.tellp());
+        out.write(padding, static_cast<std::streamsize>(entries[i].dataOffset - position));
+
+        std::ifstream in(files[i].second, std::ios::binary);
+        buffer.resize(static_cast<size_t>(entries[i].dataSize));
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+
+    Logger::output(Logger::Assets, "packed ", files.size(), " assets into ", archivePath.string(), '\n');
+    return static_cast<bool>(out);
+}
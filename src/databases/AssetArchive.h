@@ -0,0 +1,78 @@
+#ifndef ASSETARCHIVE_H
+#define ASSETARCHIVE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "SDL2/SDL.h"
+#include "../utils/MappedFile.h"
+
+namespace fs = std::filesystem;
+
+// Optional packed replacement for the loose resources/ folder
+// When resources.pak sits in the working directory or next to the executable it is mapped once
+// at startup and every database reads its assets straight out of the mapping instead of scanning directories
+//
+// Layout (little-endian):
+//   Header    magic "KOPK", version, entry count, string table size
+//   TOC       one Entry per asset, sorted by path
+//   Strings   asset paths relative to resources/, '/' separated, not null terminated
+//   Blobs     asset bytes, each starting on a blobAlignment boundary
+class AssetArchive
+{
+public:
+    static constexpr const char* defaultArchivePath = "resources.pak";
+
+    // Maps the archive if it exists, returns false (and stays on loose files) otherwise
+    static bool open(const fs::path& archivePath = defaultArchivePath);
+    // Opens defaultArchivePath from the working directory, then from the executable's directory
+    static bool openDefault();
+    static bool isOpen();
+
+    // Path relative to resources/, eg. "images/player.png"
+    static std::optional<std::string_view> find(const std::string& path);
+    static bool contains(const std::string& path);
+
+    // Read-only SDL stream over an archived asset, nullptr if it isn't packed
+    static SDL_RWops* openRW(const std::string& path);
+
+    // Paths of the assets directly inside a directory ("" for the root) with the given extension
+    static std::vector<std::string_view> list(const std::string& directory, const std::string& extension);
+
+    // Packs every file under resourcesDir into a new archive, used by the --pack launch option
+    static bool pack(const fs::path& resourcesDir, const fs::path& archivePath);
+
+    // Stem of an archived path, "images/player.png" -> "player"
+    static std::string stem(std::string_view path);
+
+private:
+    static constexpr uint32_t magic = 0x4B504F4B; // "KOPK"
+    static constexpr uint32_t version = 1;
+    static constexpr uint64_t blobAlignment = 16;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t stringTableSize;
+    };
+
+    struct Entry {
+        uint64_t dataOffset;
+        uint64_t dataSize;
+        uint32_t pathOffset;
+        uint32_t pathLength;
+    };
+
+    static inline MappedFile file;
+    static inline std::unordered_map<std::string_view, std::string_view> assets = {};
+    // Directory -> archived paths, in TOC (sorted) order
+    static inline std::unordered_map<std::string_view, std::vector<std::string_view>> directories = {};
+};
+
+#endif
@@ -3,16 +3,23 @@
 #include "lua.hpp"
 #include "LuaBridge/LuaBridge.h"
 #include "../actors/ComponentManager.h"
+#include "../core/EngineContext.h"
+#include "AssetArchive.h"
+#include "../utils/Logger.h"
 
 void AudioDB::init() {
-    AudioHelper::Mix_OpenAudio498(44100, MIX_DEFAULT_FORMAT, 2, 2048);
-    AudioHelper::Mix_AllocateChannels498(50);
-    loadAudios();
-    initialized = true;
-    instance = this;
+    State& s = state();
+    // One mixer per process, other instances keep the API with every call a no-op
+    if (EngineContext::current().isPrimary()) {
+        AudioHelper::Mix_OpenAudio498(44100, MIX_DEFAULT_FORMAT, 2, 2048);
+        AudioHelper::Mix_AllocateChannels498(50);
+        loadAudios();
+        s.initialized = true;
+    }
+    s.instance = this;
 
     // Add relevent functions to Lua API
-    luabridge::getGlobalNamespace(ComponentManager::luaState)
+    luabridge::getGlobalNamespace(ComponentManager::getLuaState())
         .beginNamespace("Audio")
         .addFunction("Play", &playAPI)
         .addFunction("Halt", &haltAudio)
@@ -22,7 +29,7 @@ void AudioDB::init() {
 
 AudioDB* AudioDB::getInstance()
 {
-    return instance;
+    return state().instance;
 }
 
 void AudioDB::playAPI(const int channel, const std::string& audioName, const bool doesLoop) {
@@ -35,23 +42,23 @@ void AudioDB::playAPI(const int channel, const std::string& audioName, const boo
 }
 
 void AudioDB::playAudio(const int channel, const std::string& audioName, const int loops) {
-    if (!initialized) {
+    State& s = state();
+    if (!s.initialized) {
         return;
     }
     else if (audioName == "") {
         return;
     }
-    else if (const auto& it = audios.find(audioName); it != audios.end()) {
+    else if (const auto& it = s.audios.find(audioName); it != s.audios.end()) {
         AudioHelper::Mix_PlayChannel498(channel, it->second, loops);
     }
     else {
-        std::cout << "error: failed to play audio clip " + audioName;
-        exit(0);
+        Logger::fatal("error: failed to play audio clip " + audioName);
     }
 }
 
 void AudioDB::playSFX(const int channel, const std::string& audioName) {
-    if (!initialized) {
+    if (!state().initialized) {
         return;
     }
     else {
@@ -61,34 +68,36 @@ void AudioDB::playSFX(const int channel, const std::string& audioName) {
 
 void AudioDB::playSFXRandomChannel(const std::string& audioName) {
     if (audioName != "") {
-        int channel = Helper::GetFrameNumber() % 48 + 2;
+        int channel = EngineContext::getFrameNumber() % 48 + 2;
         playSFX(channel, audioName);
     }
 }
 
 void AudioDB::playBGM(const std::string& audioName, const int loops) {
-    if (!initialized) {
+    State& s = state();
+    if (!s.initialized) {
         return;
     }
     else {
         stopBGM();
-        playingBGM = true;
+        s.playingBGM = true;
         playAudio(0, audioName, loops);
     }
 }
 
 void AudioDB::stopBGM() {
-    if (!initialized) {
+    State& s = state();
+    if (!s.initialized) {
         return;
     }
-    else if (playingBGM) {
-        playingBGM = false;
+    else if (s.playingBGM) {
+        s.playingBGM = false;
         AudioHelper::Mix_HaltChannel498(0);
     }
 }
 
 void AudioDB::setVolume(const int channel, const float volume) {
-    if (!initialized) {
+    if (!state().initialized) {
         return;
     }
     else {
@@ -97,7 +106,7 @@ void AudioDB::setVolume(const int channel, const float volume) {
 }
 
 void AudioDB::haltAudio(const int channel) {
-    if (!initialized) {
+    if (!state().initialized) {
         return;
     }
     else {
@@ -106,6 +115,20 @@ void AudioDB::haltAudio(const int channel) {
 }
 
 void AudioDB::loadAudios() {
+    State& s = state();
+    if (AssetArchive::isOpen()) {
+        for (const auto& extension : { ".wav", ".ogg" }) {
+            for (const auto& path : AssetArchive::list("audio", extension)) {
+                std::string audioName = AssetArchive::stem(path);
+                Mix_Chunk* raw_audio = AudioHelper::Mix_LoadWAV_RW498(AssetArchive::openRW(std::string(path)), 1);
+                if (raw_audio == nullptr) {
+                    Logger::fatal("error: failed to load audio clip " + audioName);
+                }
+                s.audios[audioName] = raw_audio;
+            }
+        }
+        return;
+    }
     if (!std::filesystem::exists(audioPath)) {
         return;
     }
@@ -115,10 +138,21 @@ void AudioDB::loadAudios() {
             std::string filePath = file.path().string();
             Mix_Chunk* raw_audio = AudioHelper::Mix_LoadWAV498(filePath.c_str());
             if (raw_audio == nullptr) {
-                std::cout << "error: failed to load audio clip " + audioName;
-                exit(0);
+                Logger::fatal("error: failed to load audio clip " + audioName);
             }
-            audios[audioName] = raw_audio;
+            s.audios[audioName] = raw_audio;
         }
     }
 }
+
+size_t AudioDB::getClipCount() {
+    return state().audios.size();
+}
+
+size_t AudioDB::getPcmBytes() {
+    size_t bytes = 0;
+    for (const auto& [name, chunk] : state().audios) {
+        bytes += chunk->alen;
+    }
+    return bytes;
+}
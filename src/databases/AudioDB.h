@@ -32,13 +32,23 @@ public:
     static void setVolume(const int channel, const float volume);
 
     static void haltAudio(const int channel);
+
+    static size_t getClipCount();
+    // Decoded PCM held by the loaded clips
+    static size_t getPcmBytes();
 private:
-    static inline AudioDB* instance = nullptr;
-    static inline bool initialized = false;
-    static inline bool playingBGM = false;
+    friend class EngineContext;
+
+    struct State {
+        AudioDB* instance = nullptr;
+        bool initialized = false;
+        bool playingBGM = false;
+        std::unordered_map<std::string, Mix_Chunk*> audios = {};
+    };
+
+    static State& state();
 
     static inline std::string audioPath = "resources/audio/";
-    static inline std::unordered_map<std::string, Mix_Chunk*> audios = {};
 
     static void loadAudios();
 };
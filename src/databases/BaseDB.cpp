@@ -5,6 +5,7 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 #include "../utils/Timer.h"
+#include "../utils/Logger.h"
 
 static void merge(rapidjson::Value& dest, const rapidjson::Value& src, rapidjson::Document::AllocatorType& allocator) {
     if (dest.IsNull()) {
@@ -181,7 +182,7 @@ bool BaseDB::readJsonFile(const std::string& path, rapidjson::Document& outDocum
 		file_pointer = fopen(path.c_str(), "rb");
     #endif
     if (file_pointer == nullptr) {
-        std::cerr << "Failed to open file: " << path << '\n';
+        Logger::warning(Logger::Assets, "Failed to open file: ", path);
         return false;
     }
     char buffer[65536]{};
@@ -191,10 +192,18 @@ bool BaseDB::readJsonFile(const std::string& path, rapidjson::Document& outDocum
 
     if (outDocument.HasParseError()) {
         rapidjson::ParseErrorCode errorCode = outDocument.GetParseError();
-        std::cout << "error parsing json at [" << path << "]\n";
-        exit(0);
+        Logger::fatal("error parsing json at [", path, "]\n");
     }
     t.stop();
     //std::cerr << "finished reading json from " << path << "\n" << t;
     return true;
+}
+
+bool BaseDB::readJsonBuffer(std::string_view buffer, const std::string& path, rapidjson::Document& outDocument) {
+    outDocument.Parse(buffer.data(), buffer.size());
+
+    if (outDocument.HasParseError()) {
+        Logger::fatal("error parsing json at [", path, "]\n");
+    }
+    return true;
 }
\ No newline at end of file
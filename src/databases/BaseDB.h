@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <iostream>
 #include <optional>
+#include <string_view>
 #include <vector>
 
 #include "rapidjson/document.h"
@@ -29,6 +30,9 @@ public:
     }
 
     void addJsonFile(rapidjson::Document& addedDoc);
+
+    // Bytes reserved by the document's pool allocator, rapidjson only hands the allocator out non-const
+    size_t getMemoryBytes() const { return const_cast<rapidjson::Document&>(doc).GetAllocator().Capacity(); }
     static void printDocument(const rapidjson::Document& doc, std::ostream& os);
 
     // getValue Variants
@@ -70,5 +74,7 @@ protected:
 	fs::path dataPath;
 
     static bool readJsonFile(const std::string& path, rapidjson::Document& outDocument);
+    // Parses json already in memory (packed assets), path is only used for error messages
+    static bool readJsonBuffer(std::string_view buffer, const std::string& path, rapidjson::Document& outDocument);
 };
 #endif
@@ -4,7 +4,9 @@
 #include <iostream>
 #include <map>
 #include "../utils/Timer.h"
+#include "AssetArchive.h"
 #include "BaseDB.h"
+#include "../utils/Logger.h"
 
 namespace fs = std::filesystem;
 
@@ -21,6 +23,10 @@ public:
     }
 
     void loadData() override {
+        if (AssetArchive::isOpen()) {
+            loadPackedData();
+            return;
+        }
         Timer t;
         // Get Basic Config/Rendering Data
         t.start();
@@ -57,26 +63,52 @@ public:
         //std::cerr << "finished parsing template data\n" << t;
     }
 
+    // Same as loadData but reading from the mapped resources.pak
+    void loadPackedData() {
+        for (const auto& path : AssetArchive::list("", ".config")) {
+            rapidjson::Document tempdoc;
+            readJsonBuffer(*AssetArchive::find(std::string(path)), "resources/" + std::string(path), tempdoc);
+            mainDoc.addJsonFile(tempdoc);
+        }
+        for (const auto& path : AssetArchive::list("actor_templates", ".template")) {
+            Datadoc templateDoc;
+            readJsonBuffer(*AssetArchive::find(std::string(path)), "resources/" + std::string(path), templateDoc.doc);
+            templates.emplace(AssetArchive::stem(path), std::move(templateDoc));
+        }
+    }
+
+    // Config and template documents
+    size_t getMemoryBytes() const {
+        size_t bytes = mainDoc.getMemoryBytes();
+        for (const auto& [templateName, templateDoc] : templates) {
+            bytes += templateDoc.getMemoryBytes();
+        }
+        return bytes;
+    }
+
     static void searchResourcesFolder() {
+        if (AssetArchive::isOpen()) {
+            if (!AssetArchive::contains("game.config")) {
+                Logger::fatal("error: resources/game.config missing");
+            }
+            return;
+        }
         if (!fs::exists(std::string("resources")))
         {
             //std::cerr << "error: " << "/resources" << " missing.\n";
             //std::cerr << "Current path is: " << fs::current_path() << "\n";
-            std::cout << "error: resources/ missing";
-            exit(0);
+            Logger::fatal("error: resources/ missing");
         }
         else if (!fs::exists(std::string("resources/game.config")))
         {
-            std::cout << "error: resources/game.config missing";
-            exit(0);
+            Logger::fatal("error: resources/game.config missing");
         }
     }
 
     void searchInitialScene() {
         if (const auto name = mainDoc.getOptionalString("initial_scene"); !name.has_value())
         {
-            std::cout << "error: initial_scene unspecified";
-            exit(0);
+            Logger::fatal("error: initial_scene unspecified");
         }
         else {
             initialSceneName = name.value();
@@ -1,20 +1,34 @@
 #ifndef SCENEDB_H
 #define SCENEDB_H
+#include "AssetArchive.h"
 #include "BaseDB.h"
+#include "../utils/Logger.h"
 
 class SceneDB : public BaseDB {
 public:
     SceneDB() : BaseDB() {}
 
     // for filename -> filepath
-    explicit SceneDB(const std::string& sceneName) : BaseDB(fs::current_path() / "resources" / "scenes" /  (sceneName + ".scene")) {
+    explicit SceneDB(const std::string& sceneName) : BaseDB(getScenePath(sceneName)) {
         name = "SceneDB";
     }
 
+    static fs::path getScenePath(const std::string& sceneName) {
+        return fs::current_path() / "resources" / "scenes" / (sceneName + ".scene");
+    }
+
+    static bool exists(const std::string& sceneName) {
+        return AssetArchive::contains("scenes/" + sceneName + ".scene") || fs::exists(getScenePath(sceneName));
+    }
+
     void loadData() override {
+        const std::string packedPath = "scenes/" + dataPath.filename().string();
+        if (const auto packed = AssetArchive::find(packedPath); packed.has_value()) {
+            readJsonBuffer(*packed, "resources/" + packedPath, mainDoc.doc);
+            return;
+        }
         if (!fs::exists(dataPath)) {
-            std::cout << "error: scene " + dataPath.stem().string() + " is missing";
-            exit(0);
+            Logger::fatal("error: scene " + dataPath.stem().string() + " is missing");
         }
         // Get Scene Data
         readJsonFile(dataPath.string(), mainDoc.doc);
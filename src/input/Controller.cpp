@@ -1,8 +1,8 @@
 #include "Controller.h"
 
-#include <iostream>
 
 #include "Input.h"
+#include "../utils/Logger.h"
 
 Controller::Controller(SDL_GameController* rawController) : controller(rawController, SDL_GameControllerClose) {
     justDownButtons.clear();
@@ -62,7 +62,7 @@ bool Controller::getButtonByString(const std::string& buttonName) const {
     if (button != SDL_CONTROLLER_BUTTON_INVALID) {
         return getButton(button);
     }
-    std::cerr << "Invalid button name: " << buttonName << "\n";
+    Logger::warning(Logger::Input, "Invalid button name: ", buttonName);
     return false;
 }
 
@@ -80,7 +80,7 @@ bool Controller::getButtonDownByString(const std::string& buttonName) const {
     if (button != SDL_CONTROLLER_BUTTON_INVALID) {
         return getButtonDown(button);
     }
-    std::cerr << "Invalid button name: " << buttonName << "\n";
+    Logger::warning(Logger::Input, "Invalid button name: ", buttonName);
     return false;
 }
 
@@ -98,13 +98,13 @@ bool Controller::getButtonUpByString(const std::string& buttonName) const {
     if (button != SDL_CONTROLLER_BUTTON_INVALID) {
         return getButtonUp(button);
     }
-    std::cerr << "Invalid button name: " << buttonName << "\n";
+    Logger::warning(Logger::Input, "Invalid button name: ", buttonName);
     return false;
 }
 
 bool Controller::setDeadzoneInt(const int deadzone) {
     if (deadzone < 0 || deadzone > AXIS_MAX_VALUE) {
-        std::cerr << "Deadzone must be between 0 and 32767 as a int\n";
+        Logger::warning(Logger::Input, "Deadzone must be between 0 and 32767 as a int");
         return false;
     }
     else {
@@ -115,7 +115,7 @@ bool Controller::setDeadzoneInt(const int deadzone) {
 
 bool Controller::setDeadzoneFloat(const float deadzone) {
     if (deadzone < 0.0f || deadzone > 1.0f) {
-        std::cerr << "Deadzone must be between 0 and 1 as a float\n";
+        Logger::warning(Logger::Input, "Deadzone must be between 0 and 1 as a float");
         return false;
     }
     else {
@@ -144,7 +144,7 @@ float Controller::getAxisValueByString(const std::string& axisName, const bool u
     if (axis != SDL_CONTROLLER_AXIS_INVALID) {
         return getAxisValue(axis, useDeadzone);
     }
-    std::cerr << "Invalid axis name: " << axisName << "\n";
+    Logger::warning(Logger::Input, "Invalid axis name: ", axisName);
     return float();
 }
 
@@ -163,7 +163,7 @@ bool Controller::getAxisPastThresholdByString(const std::string& axisName, const
     if (axis != SDL_CONTROLLER_AXIS_INVALID) {
         return getAxisPastThreshold(axis, threshold, useDeadzone);
     }
-    std::cerr << "Invalid axis name: " << axisName << "\n";
+    Logger::warning(Logger::Input, "Invalid axis name: ", axisName);
     return false;
 }
 
@@ -172,20 +172,20 @@ void Controller::printControllerInfo() const {
     if (!controllerName) {
         controllerName = "unknown controller";  // Fallback in case SDL_GameControllerName returns a null pointer
     }
-    std::cerr << "Added " << controllerName << " controller\n";
+    Logger::info(Logger::Input, "Added ", controllerName, " controller");
 
     // Print additional diagnostic information
-    std::cerr << "Mapping: " << SDL_GameControllerMapping(controller.get()) << "\n";
-    std::cerr << "Vendor: " << SDL_GameControllerGetVendor(controller.get()) << "\n";
-    std::cerr << "Product: " << SDL_GameControllerGetProduct(controller.get()) << "\n";
-    std::cerr << "Product Version: " << SDL_GameControllerGetProductVersion(controller.get()) << "\n";
+    Logger::debug(Logger::Input, "Mapping: ", SDL_GameControllerMapping(controller.get()));
+    Logger::debug(Logger::Input, "Vendor: ", SDL_GameControllerGetVendor(controller.get()));
+    Logger::debug(Logger::Input, "Product: ", SDL_GameControllerGetProduct(controller.get()));
+    Logger::debug(Logger::Input, "Product Version: ", SDL_GameControllerGetProductVersion(controller.get()));
 
     // Check supported buttons
     for (int i = 0; i < NUM_BUTTONS; ++i) {
         const SDL_GameControllerButton button = static_cast<SDL_GameControllerButton>(i);
         const char* buttonName = SDL_GameControllerGetStringForButton(button);
         bool supported = SDL_GameControllerHasButton(controller.get(), button);
-        std::cerr << "Button: " << buttonName << ", Supported: " << (supported ? "Yes" : "No") << "\n";
+        Logger::debug(Logger::Input, "Button: ", buttonName, ", Supported: ", (supported ? "Yes" : "No"));
     }
 
     // Check supported axes
@@ -193,12 +193,12 @@ void Controller::printControllerInfo() const {
         const SDL_GameControllerAxis axis = static_cast<SDL_GameControllerAxis>(i);
         const char* axisName = SDL_GameControllerGetStringForAxis(axis);
         bool supported = SDL_GameControllerHasAxis(controller.get(), axis);
-        std::cerr << "Axis: " << axisName << ", Supported: " << (supported ? "Yes" : "No") << "\n";
+        Logger::debug(Logger::Input, "Axis: ", axisName, ", Supported: ", (supported ? "Yes" : "No"));
     }
 
     // Check supported touchpads
     for (int i = 0; i < touchpadFingerStates.size(); ++i) {
-        std::cerr << "Touchpad: " << i + 1 << ", supports " << touchpadFingerStates[i].size() << " fingers\n";
+        Logger::debug(Logger::Input, "Touchpad: ", i + 1, ", supports ", touchpadFingerStates[i].size(), " fingers");
     }
 }
 
@@ -206,7 +206,7 @@ SDL_GameControllerButton Controller::stringToButton(const std::string& buttonNam
     const std::string buttonNameLower = StringToLower(buttonName);
     const auto it = button_to_sdl_controller_button.find(buttonNameLower);
     if (it == button_to_sdl_controller_button.end()) {
-        std::cerr << "Invalid button name: " << buttonNameLower << "\n";
+        Logger::warning(Logger::Input, "Invalid button name: ", buttonNameLower);
         return SDL_CONTROLLER_BUTTON_INVALID;
     }
     else {
@@ -217,7 +217,7 @@ SDL_GameControllerAxis Controller::stringToAxis(const std::string& axisName) {
     const std::string axisNameLower = StringToLower(axisName);
     const auto it = axis_to_sdl_controller_axis.find(axisNameLower);
     if (it == axis_to_sdl_controller_axis.end()) {
-        std::cerr << "Invalid axis name: " << axisNameLower << "\n";
+        Logger::warning(Logger::Input, "Invalid axis name: ", axisNameLower);
         return SDL_CONTROLLER_AXIS_INVALID;
     }
     else {
@@ -1,10 +1,11 @@
 #include "ControllerManager.h"
 
-#include <iostream>
+#include "../utils/Logger.h"
 
 void ControllerManager::initController() {
-    controllers.clear();
-    indexToJoystickID.clear();
+    State& s = state();
+    s.controllers.clear();
+    s.indexToJoystickID.clear();
     //std::cerr << "SDL_HINT_JOYSTICK_HIDAPI_PS5: " << (SDL_GetHint(SDL_HINT_JOYSTICK_HIDAPI_PS5) ? SDL_GetHint(SDL_HINT_JOYSTICK_HIDAPI_PS5) : "not set") << '\n';
     SDL_GameControllerAddMappingsFromFile("gamecontrollerdb.txt");
     //SDL_SetHint(SDL_HINT_JOYSTICK_ALLOW_BACKGROUND_EVENTS, "1");
@@ -17,6 +18,7 @@ void ControllerManager::initController() {
 }
 
 bool ControllerManager::processControllerEvent(const SDL_Event& e) {
+    State& s = state();
     switch (e.type) {
     case SDL_CONTROLLERDEVICEADDED:
         addController(e.cdevice.which); // index of new controller
@@ -25,27 +27,27 @@ bool ControllerManager::processControllerEvent(const SDL_Event& e) {
         removeController(e.cdevice.which); // instance id of removed controller
         break;
     case SDL_CONTROLLERBUTTONDOWN:
-        if (controllers.find(e.cbutton.which) != controllers.end()) {
-            controllers[e.cbutton.which]->setButtonState(INPUT_STATE_JUST_BECAME_DOWN, static_cast<SDL_GameControllerButton>(e.cbutton.button)); // instance id of removed controller
-            std::cerr << "Button " << SDL_GameControllerGetStringForButton(static_cast<SDL_GameControllerButton>(e.cbutton.button)) << " pressed down\n";
+        if (s.controllers.find(e.cbutton.which) != s.controllers.end()) {
+            s.controllers[e.cbutton.which]->setButtonState(INPUT_STATE_JUST_BECAME_DOWN, static_cast<SDL_GameControllerButton>(e.cbutton.button)); // instance id of removed controller
+            Logger::debug(Logger::Input, "Button ", SDL_GameControllerGetStringForButton(static_cast<SDL_GameControllerButton>(e.cbutton.button)), " pressed down");
         }
         break;
     case SDL_CONTROLLERBUTTONUP:
-        if (controllers.find(e.cbutton.which) != controllers.end()) {
-            controllers[e.cbutton.which]->setButtonState(INPUT_STATE_JUST_BECAME_UP, static_cast<SDL_GameControllerButton>(e.cbutton.button)); // instance id of removed controller
-            std::cerr << "Button " << SDL_GameControllerGetStringForButton(static_cast<SDL_GameControllerButton>(e.cbutton.button)) << " released\n";
+        if (s.controllers.find(e.cbutton.which) != s.controllers.end()) {
+            s.controllers[e.cbutton.which]->setButtonState(INPUT_STATE_JUST_BECAME_UP, static_cast<SDL_GameControllerButton>(e.cbutton.button)); // instance id of removed controller
+            Logger::debug(Logger::Input, "Button ", SDL_GameControllerGetStringForButton(static_cast<SDL_GameControllerButton>(e.cbutton.button)), " released");
         }
         break;
     case SDL_CONTROLLERAXISMOTION:
-        if (controllers.find(e.cbutton.which) != controllers.end()) {
-            controllers[e.caxis.which]->setAxisState(static_cast<SDL_GameControllerAxis>(e.caxis.axis), e.caxis.value); // instance id of removed controller
+        if (s.controllers.find(e.cbutton.which) != s.controllers.end()) {
+            s.controllers[e.caxis.which]->setAxisState(static_cast<SDL_GameControllerAxis>(e.caxis.axis), e.caxis.value); // instance id of removed controller
             //std::cerr << "Axis " << static_cast<SDL_GameControllerAxis>(e.caxis.axis) << " moved to " << e.caxis.value << "\n";
         }
         break;
     case SDL_CONTROLLERTOUCHPADDOWN:
-        if (controllers.find(e.ctouchpad.which) != controllers.end()) {
+        if (s.controllers.find(e.ctouchpad.which) != s.controllers.end()) {
             inputState state = INPUT_STATE_JUST_BECAME_DOWN;
-            controllers[e.ctouchpad.which]->setTouchpadFingerState(
+            s.controllers[e.ctouchpad.which]->setTouchpadFingerState(
                 e.ctouchpad.touchpad, e.ctouchpad.finger,
                 e.ctouchpad.x, e.ctouchpad.y,
                 e.ctouchpad.pressure, state);
@@ -53,9 +55,9 @@ bool ControllerManager::processControllerEvent(const SDL_Event& e) {
         }
         break;
     case SDL_CONTROLLERTOUCHPADUP:
-        if (controllers.find(e.ctouchpad.which) != controllers.end()) {
+        if (s.controllers.find(e.ctouchpad.which) != s.controllers.end()) {
             inputState state = INPUT_STATE_JUST_BECAME_UP;
-            controllers[e.ctouchpad.which]->setTouchpadFingerState(
+            s.controllers[e.ctouchpad.which]->setTouchpadFingerState(
                 e.ctouchpad.touchpad, e.ctouchpad.finger,
                 e.ctouchpad.x, e.ctouchpad.y,
                 e.ctouchpad.pressure, state);
@@ -63,9 +65,9 @@ bool ControllerManager::processControllerEvent(const SDL_Event& e) {
         }
         break;
     case SDL_CONTROLLERTOUCHPADMOTION:
-        if (controllers.find(e.ctouchpad.which) != controllers.end()) {
+        if (s.controllers.find(e.ctouchpad.which) != s.controllers.end()) {
             inputState state = INPUT_STATE_DOWN; // The finger is moving, therefore it's still down
-            controllers[e.ctouchpad.which]->setTouchpadFingerState(
+            s.controllers[e.ctouchpad.which]->setTouchpadFingerState(
                 e.ctouchpad.touchpad, e.ctouchpad.finger,
                 e.ctouchpad.x, e.ctouchpad.y,
                 e.ctouchpad.pressure, state);
@@ -79,51 +81,54 @@ bool ControllerManager::processControllerEvent(const SDL_Event& e) {
 }
 
 void ControllerManager::lateUpdate() {
-    for (const auto& [id, controller] : controllers) {
+    for (const auto& [id, controller] : state().controllers) {
         controller->lateUpdate();
     }
 }
 
 void ControllerManager::addController(const int joystickIndex) {
+    State& s = state();
     if (SDL_IsGameController(joystickIndex)) {
         SDL_GameController* rawControllerPtr = SDL_GameControllerOpen(joystickIndex);
         if (rawControllerPtr) {
             SDL_Joystick* joy = SDL_GameControllerGetJoystick(rawControllerPtr);
             SDL_JoystickID joyID = SDL_JoystickInstanceID(joy);
-            controllers[joyID] = std::make_unique<Controller>(rawControllerPtr);
-            indexToJoystickID[joystickIndex] = joyID; // Store the mapping of index to JoystickID
+            s.controllers[joyID] = std::make_unique<Controller>(rawControllerPtr);
+            s.indexToJoystickID[joystickIndex] = joyID; // Store the mapping of index to JoystickID
 
-            if (!controllers[joyID]->isConnected()) {
-                std::cerr << "Controller is not attached.\n";
+            if (!s.controllers[joyID]->isConnected()) {
+                Logger::error(Logger::Input, "Controller is not attached.");
                 exit(1);
             }
         }
         else {
-            std::cerr << "Failed to open game controller: " << SDL_GetError() << "\n";
+            Logger::error(Logger::Input, "Failed to open game controller: ", SDL_GetError());
             exit(1);
         }
     }
 }
 
 void ControllerManager::removeController(const SDL_JoystickID id) {
-    auto iter = controllers.find(id);
-    if (iter != controllers.end()) {
+    State& s = state();
+    auto iter = s.controllers.find(id);
+    if (iter != s.controllers.end()) {
         // Remove index-to-ID mapping
-        for (auto it = indexToJoystickID.begin(); it != indexToJoystickID.end(); ++it) {
+        for (auto it = s.indexToJoystickID.begin(); it != s.indexToJoystickID.end(); ++it) {
             if (it->second == id) {
-                indexToJoystickID.erase(it);
+                s.indexToJoystickID.erase(it);
                 break;
             }
         }
         // Remove the controller
-        controllers.erase(iter);
-        std::cerr << "Removed controller with ID: " << id << "\n";
+        s.controllers.erase(iter);
+        Logger::info(Logger::Input, "Removed controller with ID: ", id);
     }
 }
 
 Controller* ControllerManager::getControllerById(const SDL_JoystickID id) {
-    const auto it = controllers.find(id);
-    if (it == controllers.end()) {
+    State& s = state();
+    const auto it = s.controllers.find(id);
+    if (it == s.controllers.end()) {
         return nullptr;
     }
     else {
@@ -132,8 +137,9 @@ Controller* ControllerManager::getControllerById(const SDL_JoystickID id) {
 }
 
 Controller* ControllerManager::getControllerByIndex(const int index) {
-    const auto it = indexToJoystickID.find(index - 1);
-    if (it == indexToJoystickID.end()) {
+    State& s = state();
+    const auto it = s.indexToJoystickID.find(index - 1);
+    if (it == s.indexToJoystickID.end()) {
         return nullptr;
     }
     else {
@@ -142,11 +148,11 @@ Controller* ControllerManager::getControllerByIndex(const int index) {
     }
 }
 
-size_t ControllerManager::getControllerCount() { return controllers.size(); }
+size_t ControllerManager::getControllerCount() { return state().controllers.size(); }
 
 bool ControllerManager::getControllerButton(const SDL_GameControllerButton buttonName, const int playerId) {
     if (playerId == -1) {
-        for (const auto& [id, controller] : controllers) {
+        for (const auto& [id, controller] : state().controllers) {
             if (controller->getButton(buttonName)) { return true; }
         }
     }
@@ -159,7 +165,7 @@ bool ControllerManager::getControllerButton(const SDL_GameControllerButton butto
 
 bool ControllerManager::getControllerButtonDown(SDL_GameControllerButton controllerButton, int playerId) {
     if (playerId == -1) {
-        for (const auto& [id, controller] : controllers) {
+        for (const auto& [id, controller] : state().controllers) {
             if (controller->getButtonDown(controllerButton)) { return true; }
         }
     }
@@ -172,7 +178,7 @@ bool ControllerManager::getControllerButtonDown(SDL_GameControllerButton control
 
 bool ControllerManager::getControllerButtonUp(SDL_GameControllerButton controllerButton, int playerId) {
     if (playerId == -1) {
-        for (const auto& [id, controller] : controllers) {
+        for (const auto& [id, controller] : state().controllers) {
             if (controller->getButtonUp(controllerButton)) { return true; }
         }
     }
@@ -185,7 +191,7 @@ bool ControllerManager::getControllerButtonUp(SDL_GameControllerButton controlle
 
 bool ControllerManager::getControllerAxisPastThreshold(const SDL_GameControllerAxis axisName, const float threshold, const bool useDeadzone, const int playerId) {
     if (playerId == -1) {
-        for (const auto& [id, controller] : controllers) {
+        for (const auto& [id, controller] : state().controllers) {
             if (controller->getAxisPastThreshold(axisName, threshold, useDeadzone)) { return true; }
         }
     }
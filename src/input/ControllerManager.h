@@ -37,7 +37,13 @@ public:
 	static bool getControllerAxisPastThreshold(SDL_GameControllerAxis axisName, float threshold = 0.5, bool useDeadzone = true, int playerId = -1);
 
 private:
-    static inline std::unordered_map<SDL_JoystickID, std::unique_ptr<Controller>> controllers = {};
-    static inline std::unordered_map<int, SDL_JoystickID> indexToJoystickID;
+    friend class EngineContext;
+
+    struct State {
+        std::unordered_map<SDL_JoystickID, std::unique_ptr<Controller>> controllers = {};
+        std::unordered_map<int, SDL_JoystickID> indexToJoystickID;
+    };
+
+    static State& state();
 };
 #endif
\ No newline at end of file
@@ -1,16 +1,20 @@
 #include "Input.h"
-#include <iostream>
 #include "../actors/ComponentManager.h"
+#include "../core/EngineContext.h"
+#include "../utils/Logger.h"
 
 void Input::init() {
     Keyboard::init();
     Mouse::init();
-    ControllerManager::initController();
+    // Controller events only reach the primary instance
+    if (EngineContext::current().isPrimary()) {
+        ControllerManager::initController();
+    }
 
     // Input Mouse & Keyboard API functions + GetController
     // TODO: When not working with autograder, move Keyboard and Mouse to their own namespace
     // TODO: When not working with autograder, add sensitivity & haptics API functions
-    luabridge::getGlobalNamespace(ComponentManager::luaState)
+    luabridge::getGlobalNamespace(ComponentManager::getLuaState())
         .beginNamespace("Input")
         .addFunction("GetKey", &Keyboard::getKeyByString)
         .addFunction("GetKeyDown", &Keyboard::getKeyDownByString)
@@ -31,7 +35,7 @@ void Input::init() {
         .endNamespace();
 
     // Register Controller class with Lua
-    luabridge::getGlobalNamespace(ComponentManager::luaState)
+    luabridge::getGlobalNamespace(ComponentManager::getLuaState())
         .beginClass<Controller>("controller")
         .addFunction("GetButton", &Controller::getButtonByString)
         .addFunction("GetButtonDown", &Controller::getButtonDownByString)
@@ -70,9 +74,10 @@ void Input::lateUpdate() {
 }
 
 bool Input::removeActionBinding(const std::string& actionName) {
-    const auto it = actionMap.find(actionName);
-    if (it != actionMap.end()) {
-        actionMap.erase(it);
+    State& s = state();
+    const auto it = s.actionMap.find(actionName);
+    if (it != s.actionMap.end()) {
+        s.actionMap.erase(it);
         return true;
     }
     return false;
@@ -162,14 +167,15 @@ bool Input::addInputBinding(const std::string& actionName, const std::string& in
     }
     }
 
-    actionMap[actionName].bindings.push_back(newBinding);
+    state().actionMap[actionName].bindings.push_back(newBinding);
     return true;
 }
 
 bool Input::removeInputBinding(const std::string& actionName, const std::string& inputType,
     const std::string& inputName) {
-    const auto it = actionMap.find(actionName);
-    if (it == actionMap.end()) return false; // Action not found
+    State& s = state();
+    const auto it = s.actionMap.find(actionName);
+    if (it == s.actionMap.end()) return false; // Action not found
     auto& bindings = it->second.bindings;
     const InputBinding::Type queryType = getInputTypeFromString(inputType);
     bool retval = false;
@@ -275,8 +281,9 @@ bool Input::removeInputBinding(const std::string& actionName, const std::string&
 }
 
 bool Input::toggleActionInputType(const std::string& actionName, const std::string& inputType) {
-    const auto it = actionMap.find(actionName);
-    if (it == actionMap.end()) return false; // Action not found
+    State& s = state();
+    const auto it = s.actionMap.find(actionName);
+    if (it == s.actionMap.end()) return false; // Action not found
     ActionBinding& action = it->second;
     switch (getInputTypeFromString(inputType)) {
     case InputBinding::KEYBOARD_DOWN:
@@ -304,13 +311,14 @@ bool Input::toggleActionInputType(const std::string& actionName, const std::stri
 }
 
 bool Input::resetAllActionBindings() {
-    actionMap.clear();
+    state().actionMap.clear();
     return true;
 }
 
 bool Input::getAction(const std::string& actionName) {
-    const auto it = actionMap.find(actionName);
-    if (it != actionMap.end()) {
+    State& s = state();
+    const auto it = s.actionMap.find(actionName);
+    if (it != s.actionMap.end()) {
         ActionBinding& action = it->second;
         for (const InputBinding& binding : action.bindings) {
             switch (binding.type) {
@@ -383,6 +391,6 @@ InputBinding::Type Input::getInputTypeFromString(const std::string& inputType) {
     if (inputTypeLower == "controller_button_just_down") { return InputBinding::CONTROLLER_BUTTON_JUST_DOWN; }
     if (inputTypeLower == "controller_button_just_up") { return InputBinding::CONTROLLER_BUTTON_JUST_UP; }
     if (inputTypeLower == "controller_axis") { return InputBinding::CONTROLLER_AXIS; }
-    std::cerr << "Invalid input type: " << inputTypeLower << "\n";
+    Logger::warning(Logger::Input, "Invalid input type: ", inputTypeLower);
     return InputBinding::NONE; // Return NONE for invalid input types
 }
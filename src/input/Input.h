@@ -39,7 +39,13 @@ public:
 	static bool getAction(const std::string& actionName);
 
 private:
-	static inline std::unordered_map<std::string, ActionBinding> actionMap;
+	friend class EngineContext;
+
+	struct State {
+		std::unordered_map<std::string, ActionBinding> actionMap;
+	};
+
+	static State& state();
 
 	static void saveActionMapToFile(const std::string& filename);
 
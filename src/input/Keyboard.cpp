@@ -1,28 +1,30 @@
 #include "Keyboard.h"
 
-#include <iostream>
 
 #include "InputConversionMaps.h"
+#include "../utils/Logger.h"
 
 void Keyboard::init() {
-    keyboardStates.clear();
-    justDownScancodes.clear();
-    justUpScancodes.clear();
+    State& s = state();
+    s.keyboardStates.clear();
+    s.justDownScancodes.clear();
+    s.justUpScancodes.clear();
     for (int keycode = SDL_SCANCODE_UNKNOWN; keycode < SDL_NUM_SCANCODES; keycode++) {
-        keyboardStates[static_cast<SDL_Scancode>(keycode)] = INPUT_STATE_UP;
+        s.keyboardStates[static_cast<SDL_Scancode>(keycode)] = INPUT_STATE_UP;
     }
 }
 
 bool Keyboard::processKeyboardEvent(const SDL_Event& e) {
+    State& s = state();
     if (e.type == SDL_KEYDOWN) {
         //std::cerr << e.key.keysym.scancode << " pressed down\n";
-        keyboardStates[e.key.keysym.scancode] = INPUT_STATE_JUST_BECAME_DOWN;
-        justDownScancodes.push_back(e.key.keysym.scancode);
+        s.keyboardStates[e.key.keysym.scancode] = INPUT_STATE_JUST_BECAME_DOWN;
+        s.justDownScancodes.push_back(e.key.keysym.scancode);
     }
     else if (e.type == SDL_KEYUP) {
         //std::cerr << e.key.keysym.scancode << " released\n";
-        keyboardStates[e.key.keysym.scancode] = INPUT_STATE_JUST_BECAME_UP;
-        justUpScancodes.push_back(e.key.keysym.scancode);
+        s.keyboardStates[e.key.keysym.scancode] = INPUT_STATE_JUST_BECAME_UP;
+        s.justUpScancodes.push_back(e.key.keysym.scancode);
     }
     else {
         return false;
@@ -31,19 +33,21 @@ bool Keyboard::processKeyboardEvent(const SDL_Event& e) {
 }
 
 void Keyboard::lateUpdate() {
-    for (const SDL_Scancode& scancode : justDownScancodes) {
-        keyboardStates[scancode] = INPUT_STATE_DOWN;
+    State& s = state();
+    for (const SDL_Scancode& scancode : s.justDownScancodes) {
+        s.keyboardStates[scancode] = INPUT_STATE_DOWN;
     }
-    justDownScancodes.clear();
+    s.justDownScancodes.clear();
 
-    for (const SDL_Scancode& scancode : justUpScancodes) {
-        keyboardStates[scancode] = INPUT_STATE_UP;
+    for (const SDL_Scancode& scancode : s.justUpScancodes) {
+        s.keyboardStates[scancode] = INPUT_STATE_UP;
     }
-    justUpScancodes.clear();
+    s.justUpScancodes.clear();
 }
 
 bool Keyboard::getKeyByScancode(SDL_Scancode keycode) {
-    return keyboardStates[keycode] == INPUT_STATE_DOWN || keyboardStates[keycode] == INPUT_STATE_JUST_BECAME_DOWN;
+    State& s = state();
+    return s.keyboardStates[keycode] == INPUT_STATE_DOWN || s.keyboardStates[keycode] == INPUT_STATE_JUST_BECAME_DOWN;
 }
 
 bool Keyboard::getKeyByString(const std::string& keyname)
@@ -56,7 +60,7 @@ bool Keyboard::getKeyByString(const std::string& keyname)
 }
 
 bool Keyboard::getKeyDownByScancode(SDL_Scancode keycode) {
-    return keyboardStates[keycode] == INPUT_STATE_JUST_BECAME_DOWN;
+    return state().keyboardStates[keycode] == INPUT_STATE_JUST_BECAME_DOWN;
 }
 
 bool Keyboard::getKeyDownByString(const std::string& keyname)
@@ -69,7 +73,7 @@ bool Keyboard::getKeyDownByString(const std::string& keyname)
 }
 
 bool Keyboard::getKeyUpByScancode(SDL_Scancode keycode) {
-    return keyboardStates[keycode] == INPUT_STATE_JUST_BECAME_UP;
+    return state().keyboardStates[keycode] == INPUT_STATE_JUST_BECAME_UP;
 }
 
 bool Keyboard::getKeyUpByString(const std::string& keyname) {
@@ -85,7 +89,7 @@ SDL_Scancode Keyboard::stringToScancode(const std::string& keyname) {
     const auto it = keycode_to_scancode.find(keyNameLower);
     if (it == keycode_to_scancode.end()) {
         // Invalid keycode
-        std::cerr << "Invalid keycode " << keyNameLower << "\n";
+        Logger::warning(Logger::Input, "Invalid keycode ", keyNameLower);
         return SDL_SCANCODE_UNKNOWN;
     }
     else {
@@ -32,8 +32,14 @@ public:
 	static SDL_Scancode stringToScancode(const std::string& keyname);
 
 private:
-	static inline std::unordered_map<SDL_Scancode, inputState> keyboardStates;
-	static inline std::vector<SDL_Scancode> justDownScancodes;
-	static inline std::vector<SDL_Scancode> justUpScancodes;
+	friend class EngineContext;
+
+	struct State {
+		std::unordered_map<SDL_Scancode, inputState> keyboardStates;
+		std::vector<SDL_Scancode> justDownScancodes;
+		std::vector<SDL_Scancode> justUpScancodes;
+	};
+
+	static State& state();
 };
 #endif
\ No newline at end of file
@@ -1,31 +1,33 @@
 #include "Mouse.h"
 
-#include <iostream>
 
 #include "InputConversionMaps.h"
+#include "../utils/Logger.h"
 
 void Mouse::init() {
-    for (auto& mouseButtonState : mouseButtonStates) {
+    State& s = state();
+    for (auto& mouseButtonState : s.mouseButtonStates) {
         mouseButtonState = INPUT_STATE_UP;
     }
-    justDownMouseButtons.clear();
-    justUpMouseButtons.clear();
+    s.justDownMouseButtons.clear();
+    s.justUpMouseButtons.clear();
 }
 
 bool Mouse::processMouseEvent(const SDL_Event& e) {
+    State& s = state();
     if (e.type == SDL_MOUSEBUTTONDOWN) {
-        mouseButtonStates[e.button.button - 1] = INPUT_STATE_JUST_BECAME_DOWN;
-        justDownMouseButtons.push_back(e.button.button - 1);
+        s.mouseButtonStates[e.button.button - 1] = INPUT_STATE_JUST_BECAME_DOWN;
+        s.justDownMouseButtons.push_back(e.button.button - 1);
     }
     else if (e.type == SDL_MOUSEBUTTONUP) {
-        mouseButtonStates[e.button.button - 1] = INPUT_STATE_JUST_BECAME_UP;
-        justUpMouseButtons.push_back(e.button.button - 1);
+        s.mouseButtonStates[e.button.button - 1] = INPUT_STATE_JUST_BECAME_UP;
+        s.justUpMouseButtons.push_back(e.button.button - 1);
     }
     else if (e.type == SDL_MOUSEMOTION) {
-        mousePosition = glm::vec2(e.motion.x, e.motion.y);
+        s.mousePosition = glm::vec2(e.motion.x, e.motion.y);
     }
     else if (e.type == SDL_MOUSEWHEEL) {
-        mouseScrollThisFrame = e.wheel.preciseY;
+        s.mouseScrollThisFrame = e.wheel.preciseY;
     }
     else {
         return false;
@@ -34,24 +36,26 @@ bool Mouse::processMouseEvent(const SDL_Event& e) {
 }
 
 void Mouse::lateUpdate() {
-    for (const int& button : justDownMouseButtons) {
-        mouseButtonStates[button] = INPUT_STATE_DOWN;
+    State& s = state();
+    for (const int& button : s.justDownMouseButtons) {
+        s.mouseButtonStates[button] = INPUT_STATE_DOWN;
     }
-    justDownMouseButtons.clear();
+    s.justDownMouseButtons.clear();
 
-    for (const int& button : justUpMouseButtons) {
-        mouseButtonStates[button] = INPUT_STATE_UP;
+    for (const int& button : s.justUpMouseButtons) {
+        s.mouseButtonStates[button] = INPUT_STATE_UP;
     }
-    justUpMouseButtons.clear();
+    s.justUpMouseButtons.clear();
 
-    mouseScrollThisFrame = 0;
+    s.mouseScrollThisFrame = 0;
 }
 
 bool Mouse::getMouseButton(int button)
 {
+    State& s = state();
     // SDL Mouse button indices start at 1
     if (button >= 1 && button < NUMBER_OF_MOUSE_BUTTONS) {
-        return mouseButtonStates[button - 1] == INPUT_STATE_DOWN || mouseButtonStates[button - 1] == INPUT_STATE_JUST_BECAME_DOWN;
+        return s.mouseButtonStates[button - 1] == INPUT_STATE_DOWN || s.mouseButtonStates[button - 1] == INPUT_STATE_JUST_BECAME_DOWN;
     }
     else {
         // Invalid mouse button
@@ -71,7 +75,7 @@ bool Mouse::getMouseButtonDown(int button)
 {
     // SDL Mouse button indices start at 1
     if (button >= 1 && button < NUMBER_OF_MOUSE_BUTTONS) {
-        return mouseButtonStates[button - 1] == INPUT_STATE_JUST_BECAME_DOWN;
+        return state().mouseButtonStates[button - 1] == INPUT_STATE_JUST_BECAME_DOWN;
     }
     else {
         // Invalid mouse button
@@ -91,7 +95,7 @@ bool Mouse::getMouseButtonUp(int button)
 {
     // SDL Mouse button indices start at 1
     if (button >= 1 && button < NUMBER_OF_MOUSE_BUTTONS) {
-        return mouseButtonStates[button - 1] == INPUT_STATE_JUST_BECAME_UP;
+        return state().mouseButtonStates[button - 1] == INPUT_STATE_JUST_BECAME_UP;
     }
     else {
         // Invalid mouse button
@@ -109,19 +113,19 @@ bool Mouse::getMouseButtonUpByString(const std::string& buttonName) {
 
 glm::vec2 Mouse::getMousePosition()
 {
-    return mousePosition;
+    return state().mousePosition;
 }
 
 float Mouse::getMouseScrollDelta()
 {
-    return mouseScrollThisFrame;
+    return state().mouseScrollThisFrame;
 }
 
 int Mouse::stringToMouseButton(const std::string& buttonName) {
     const std::string buttonNameLower = StringToLower(buttonName);
     const auto it = button_to_sdl_mouse_button.find(buttonNameLower);
     if (it == button_to_sdl_mouse_button.end()) {
-        std::cerr << "Invalid mouse button: " << buttonName << "\n";
+        Logger::warning(Logger::Input, "Invalid mouse button: ", buttonName);
         return -1;
     }
     return it->second;
@@ -40,13 +40,19 @@ public:
 
 	static int stringToMouseButton(const std::string& buttonName);
 private:
-	// Mouse buttons
-	static inline inputState mouseButtonStates[NUMBER_OF_MOUSE_BUTTONS];
-	static inline std::vector<int> justDownMouseButtons;
-	static inline std::vector<int> justUpMouseButtons;
-
-	// Mouse other
-	static inline glm::vec2 mousePosition;
-	static inline float mouseScrollThisFrame = 0;
+	friend class EngineContext;
+
+	struct State {
+		// Mouse buttons
+		inputState mouseButtonStates[NUMBER_OF_MOUSE_BUTTONS] = {};
+		std::vector<int> justDownMouseButtons;
+		std::vector<int> justUpMouseButtons;
+
+		// Mouse other
+		glm::vec2 mousePosition = glm::vec2(0.0f);
+		float mouseScrollThisFrame = 0;
+	};
+
+	static State& state();
 };
 #endif
\ No newline at end of file
@@ -1,24 +1,44 @@
 #include "FontDB.h"
 #include <filesystem>
-#include <iostream>
+#include "../databases/AssetArchive.h"
+#include "../utils/Logger.h"
 
 
 FontDB::FontDB() {}
 
 FontDB* FontDB::getInstance()
 {
-    return instance;
+    return state().instance;
 }
 
 void FontDB::init() {
-    instance = this;
+    State& s = state();
+    s.instance = this;
 
-    TTF_Init();
-    initialized = true;
+    {
+        // Reference counted, every instance initializes it once
+        const std::lock_guard<std::mutex> lock(ttfMutex());
+        TTF_Init();
+    }
+    s.initialized = true;
+}
+
+FontDB::State::~State() {
+    const std::lock_guard<std::mutex> lock(ttfMutex());
+    for (const auto& [name, sizes] : fonts) {
+        for (const auto& [size, font] : sizes) {
+            TTF_CloseFont(font);
+        }
+    }
+}
+
+std::mutex& FontDB::ttfMutex() {
+    static std::mutex mutex;
+    return mutex;
 }
 
 void FontDB::initCheck() {
-    if (!initialized) {
+    if (!state().initialized) {
         //std::cerr << "error: never initialized FontDB";
         exit(1);
     }
@@ -30,15 +50,30 @@ TTF_Font* FontDB::getFont(const std::string& fontName, const int fontSize) {
 }
 
 TTF_Font* FontDB::initFont(const std::string& fontName, const int fontSize) {
+    State& s = state();
     initCheck();
 
     // Check if font is already loaded
-    if (const auto& fontNameIt = fonts.find(fontName); fontNameIt != fonts.end()) {
+    if (const auto& fontNameIt = s.fonts.find(fontName); fontNameIt != s.fonts.end()) {
         if (const auto& fontSizeIt = fontNameIt->second.find(fontSize); fontSizeIt != fontNameIt->second.end()) {
             return fontSizeIt->second;
         }
     }
 
+    // Fonts inside resources.pak are opened straight from the mapping
+    if (const auto packedFont = AssetArchive::openRW("fonts/" + fontName + ".ttf"); packedFont != nullptr) {
+        TTF_Font* font = nullptr;
+        {
+            const std::lock_guard<std::mutex> lock(ttfMutex());
+            font = TTF_OpenFontRW(packedFont, 1, fontSize);
+        }
+        if (font == nullptr) {
+            Logger::fatal("error: failed to load font " + fontName);
+        }
+        s.fonts[fontName][fontSize] = font;
+        return font;
+    }
+
     // Check if font folder even exists
     if (!std::filesystem::is_directory(fontFolder)) {
         //std::cerr << "fontFolder doesn't exist or isn't a directory";
@@ -48,16 +83,26 @@ TTF_Font* FontDB::initFont(const std::string& fontName, const int fontSize) {
     // Check if font file exists
     std::filesystem::path fontPath = fontFolder + (fontName + ".ttf");
     if (!std::filesystem::exists(fontPath)) {
-        std::cout << "error: font " + fontName + " missing";
-        exit(0);
+        Logger::fatal("error: font " + fontName + " missing");
     }
 
     // Load font and cache
-    TTF_Font* font = TTF_OpenFont(fontPath.string().c_str(), fontSize);
+    TTF_Font* font = nullptr;
+    {
+        const std::lock_guard<std::mutex> lock(ttfMutex());
+        font = TTF_OpenFont(fontPath.string().c_str(), fontSize);
+    }
     if (font == nullptr) {
-        std::cout << "error: failed to load font " + fontName;
-        exit(0);
+        Logger::fatal("error: failed to load font " + fontName);
     }
-    fonts[fontName][fontSize] = font;
+    s.fonts[fontName][fontSize] = font;
     return font;
+}
+
+size_t FontDB::getFontCount() {
+    size_t count = 0;
+    for (const auto& [name, sizes] : state().fonts) {
+        count += sizes.size();
+    }
+    return count;
 }
\ No newline at end of file
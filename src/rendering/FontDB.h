@@ -2,6 +2,7 @@
 #define FONTDB_H
 
 #include "SDL2_ttf/SDL_ttf.h"
+#include <mutex>
 #include <unordered_map>
 #include <string>
 
@@ -14,12 +15,30 @@ public:
 
     static TTF_Font* getFont(const std::string& fontName, const int fontSize);
 
+    // Open font faces, one per name and size
+    static size_t getFontCount();
+
 private:
-    static inline FontDB* instance = nullptr;
-    static inline bool initialized = false;
+    friend class EngineContext;
+
+    struct State {
+        FontDB* instance = nullptr;
+        bool initialized = false;
+        std::unordered_map<std::string, std::unordered_map<int, TTF_Font*>> fonts = {};
+
+        State() = default;
+        State(const State&) = delete;
+        State& operator=(const State&) = delete;
+        ~State();
+    };
+
+    static State& state();
+
+    // SDL_ttf shares one FreeType library between instances, opening and closing faces goes through this
+    // Drawing with a face needs no lock, every instance opens its own
+    static std::mutex& ttfMutex();
 
     static inline std::string fontFolder = "resources/fonts/";
-    static inline std::unordered_map<std::string, std::unordered_map<int, TTF_Font*>> fonts = {};
 
     static void initCheck();
     static TTF_Font* initFont(const std::string& fontName, const int fontSize);
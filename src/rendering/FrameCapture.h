@@ -0,0 +1,88 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SDL2/SDL.h"
+#include "../databases/ResourcesDB.h"
+
+// Writes the frames Helper::SDL_RenderPresent498 captures in recording/autograder mode on a background thread
+// Each present reads the frame back into one of a ring of reusable surfaces and moves on, the writer thread
+// saves it behind the loop. The loop only waits when every surface is still queued for writing.
+//
+// "bmp" (the default, and always in autograder mode) writes the same frame_00000.bmp files Helper does.
+// "delta" writes frame_00000.kfd instead: the frame XORed with the previous one and run-length coded
+// (see FrameDelta), with a full keyframe every keyframeInterval frames. --expand-frames turns them back into BMPs.
+class FrameCapture
+{
+public:
+    enum class Format { Bmp, Delta };
+
+    // Installs capture() as Helper's frame capture
+    static void init(const ResourcesDB& configDB);
+    // Writes out every queued frame and stops the writer thread, also run at exit
+    static void shutDown();
+
+    static void capture(SDL_Renderer* renderer, int frameNumber);
+
+    // Rewrites every .kfd in directory as the .bmp the "bmp" format would have written
+    static bool expand(const std::filesystem::path& directory);
+
+    // Presents that had to wait for a free surface
+    static int getStalls();
+
+private:
+    static constexpr uint32_t magic = 0x44464F4B; // "KOFD"
+    static constexpr uint32_t version = 1;
+    static constexpr uint32_t flagKeyframe = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+        uint32_t frameNumber;
+        uint32_t flags;
+    };
+
+    struct Slot {
+        SDL_Surface* surface = nullptr;
+        int frameNumber = 0;
+    };
+
+    static inline Format format = Format::Bmp;
+    static inline int ringSize = 8;
+    static inline int keyframeInterval = 120;
+
+    static inline std::vector<Slot> slots = {};
+    static inline std::deque<int> freeSlots = {};
+    static inline std::deque<int> queuedSlots = {};
+    static inline std::mutex mutex;
+    static inline std::condition_variable slotFreed;
+    static inline std::condition_variable frameQueued;
+    static inline std::thread writer;
+    static inline bool stopping = false;
+    static inline int stalls = 0;
+
+    // Writer thread only, the last frame written in delta mode
+    static inline std::vector<uint8_t> previousFrame = {};
+    static inline std::vector<uint8_t> currentFrame = {};
+    static inline std::vector<uint8_t> encoded = {};
+    static inline int previousFrameNumber = -1;
+    static inline int framesSinceKeyframe = 0;
+
+    static void allocateRing(SDL_Renderer* renderer);
+    static void writeFrames();
+    static void writeBmp(const Slot& slot);
+    static void writeDelta(const Slot& slot);
+    static std::string framePath(int frameNumber, const char* extension);
+};
+
+#endif
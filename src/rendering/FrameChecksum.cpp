@@ -0,0 +1,169 @@
+#include "FrameChecksum.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "../external_helpers/Helper.h"
+#include "../utils/FrameHash.h"
+#include "../utils/MappedFile.h"
+#include "../utils/Logger.h"
+
+void FrameChecksum::init() {
+    const char* modeName = SDL_getenv("FRAMECHECKSUM");
+    if (modeName == nullptr) {
+        return;
+    }
+    const std::string modeString = modeName;
+    if (modeString == "record") {
+        mode = Mode::Record;
+    }
+    else if (modeString == "verify") {
+        mode = Mode::Verify;
+    }
+    else {
+        Logger::warning(Logger::Render, "FRAMECHECKSUM must be record or verify, got ", modeString);
+        return;
+    }
+
+    const char* logName = SDL_getenv("FRAMECHECKSUM_FILE");
+    const std::filesystem::path logPath = logName != nullptr ? logName : defaultLogPath;
+    std::filesystem::path outputPath = logPath;
+    if (mode == Mode::Verify) {
+        Header header{};
+        std::vector<Record> records;
+        if (!readLog(logPath, header, records)) {
+            Logger::warning(Logger::Render, "FRAMECHECKSUM=verify needs a recorded ", logPath.string());
+            mode = Mode::Off;
+            return;
+        }
+        for (const Record& record : records) {
+            if (record.frameNumber >= expected.size()) {
+                expected.resize(record.frameNumber + 1, 0);
+                expectedPresent.resize(record.frameNumber + 1, false);
+            }
+            expected[record.frameNumber] = record.hash;
+            expectedPresent[record.frameNumber] = true;
+        }
+        if (!std::filesystem::exists(Helper::frame_directory_relative_path)) {
+            std::filesystem::create_directory(Helper::frame_directory_relative_path);
+        }
+        outputPath = std::filesystem::path(Helper::frame_directory_relative_path) / defaultLogPath;
+    }
+
+    log.open(outputPath, std::ios::binary | std::ios::trunc);
+    headerWritten = false;
+    Helper::frame_capture = &FrameChecksum::capture;
+    Helper::force_frame_capture = true;
+    std::atexit(&FrameChecksum::shutDown);
+}
+
+void FrameChecksum::shutDown() {
+    if (mode == Mode::Off) {
+        return;
+    }
+    log.close();
+    // stdout is compared by the autograder, the summary goes to stderr
+    if (mode == Mode::Verify) {
+        if (mismatches == 0) {
+            Logger::info(Logger::Render, "frame checksums: ", framesChecked, " frames match");
+        }
+        else {
+            Logger::warning(Logger::Render, "frame checksums: ", mismatches, " of ", framesChecked, " frames differ, first at frame ", firstMismatch);
+        }
+    }
+    mode = Mode::Off;
+}
+
+void FrameChecksum::capture(SDL_Renderer* renderer, int frameNumber) {
+    int width = 0;
+    int height = 0;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+    const int pitch = width * 3;
+    pixels.resize(static_cast<size_t>(pitch) * height);
+    if (SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_RGB24, pixels.data(), pitch) != 0) {
+        SDL_Log("SDL_RenderReadPixels() failed: %s", SDL_GetError());
+    }
+
+    if (!headerWritten) {
+        const Header header{ magic, version, static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+        log.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        headerWritten = true;
+    }
+    const Record record{ static_cast<uint32_t>(frameNumber), 0, FrameHash::hash(pixels.data(), pixels.size()) };
+    log.write(reinterpret_cast<const char*>(&record), sizeof(Record));
+
+    if (mode == Mode::Verify) {
+        framesChecked++;
+        const size_t index = static_cast<size_t>(frameNumber);
+        if (index >= expected.size() || !expectedPresent[index] || expected[index] != record.hash) {
+            if (mismatches++ == 0) {
+                firstMismatch = frameNumber;
+            }
+            dumpFrame(frameNumber, width, height);
+        }
+    }
+}
+
+void FrameChecksum::dumpFrame(int frameNumber, int width, int height) {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(pixels.data(), width, height, 24, width * 3, SDL_PIXELFORMAT_RGB24);
+    std::stringstream filenameStream;
+    filenameStream << "frame_" << std::setw(5) << std::setfill('0') << frameNumber << ".bmp";
+    const std::string path = Helper::frame_directory_relative_path + "/" + filenameStream.str();
+    if (surface == nullptr || SDL_SaveBMP(surface, path.c_str()) != 0) {
+        SDL_Log("SDL_SaveBMP() failed: %s", SDL_GetError());
+    }
+    SDL_FreeSurface(surface);
+}
+
+bool FrameChecksum::readLog(const std::filesystem::path& path, Header& header, std::vector<Record>& records) {
+    MappedFile file;
+    if (!file.openReadOnly(path) || file.size() < sizeof(Header)) {
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(Header));
+    if (header.magic != magic || header.version != version) {
+        return false;
+    }
+    // A run cut short mid-write leaves a partial record, it's ignored
+    records.resize((file.size() - sizeof(Header)) / sizeof(Record));
+    std::memcpy(records.data(), file.data() + sizeof(Header), records.size() * sizeof(Record));
+    return true;
+}
+
+bool FrameChecksum::compare(const std::filesystem::path& expectedPath, const std::filesystem::path& actualPath) {
+    Header expectedHeader{};
+    Header actualHeader{};
+    std::vector<Record> expectedRecords;
+    std::vector<Record> actualRecords;
+    if (!readLog(expectedPath, expectedHeader, expectedRecords)) {
+        Logger::output(Logger::Render, "error: ", expectedPath.string(), " is not a checksum log");
+        return false;
+    }
+    if (!readLog(actualPath, actualHeader, actualRecords)) {
+        Logger::output(Logger::Render, "error: ", actualPath.string(), " is not a checksum log");
+        return false;
+    }
+    if (expectedHeader.width != actualHeader.width || expectedHeader.height != actualHeader.height) {
+        Logger::output(Logger::Render, "resolution differs: ", expectedHeader.width, "x", expectedHeader.height,
+            " vs ", actualHeader.width, "x", actualHeader.height, '\n');
+        return false;
+    }
+
+    const size_t common = std::min(expectedRecords.size(), actualRecords.size());
+    for (size_t i = 0; i < common; i++) {
+        if (expectedRecords[i].frameNumber != actualRecords[i].frameNumber || expectedRecords[i].hash != actualRecords[i].hash) {
+            Logger::output(Logger::Render, "first divergent frame: ", std::min(expectedRecords[i].frameNumber, actualRecords[i].frameNumber), '\n');
+            return false;
+        }
+    }
+    if (expectedRecords.size() != actualRecords.size()) {
+        Logger::output(Logger::Render, "first divergent frame: ", common, " (", expectedRecords.size(), " vs ", actualRecords.size(), " frames)\n");
+        return false;
+    }
+    Logger::output(Logger::Render, "all ", common, " frames match\n");
+    return true;
+}
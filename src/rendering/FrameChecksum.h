@@ -0,0 +1,66 @@
+#ifndef FRAMECHECKSUM_H
+#define FRAMECHECKSUM_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "SDL2/SDL.h"
+
+// Regression runs by frame hash instead of full BMP dumps, chosen with the FRAMECHECKSUM environment variable
+//   record  every presented frame is hashed (FrameHash) into the checksum log, no images are written
+//   verify  frames are hashed against a recorded log, only frames that differ are saved as BMPs
+// The log is FRAMECHECKSUM_FILE, frame_checksums.kfh by default. In verify mode the run's own hashes go to
+// frames/frame_checksums.kfh so two runs can be compared afterwards with --compare-checksums.
+class FrameChecksum
+{
+public:
+    // Installs capture() as Helper's frame capture if FRAMECHECKSUM is set, overriding FrameCapture
+    static void init();
+    // Flushes the log and reports mismatches on stderr, also run at exit
+    static void shutDown();
+
+    static void capture(SDL_Renderer* renderer, int frameNumber);
+
+    // Prints the first frame at which two logs differ, returns false if they do
+    static bool compare(const std::filesystem::path& expectedPath, const std::filesystem::path& actualPath);
+
+private:
+    enum class Mode { Off, Record, Verify };
+
+    static constexpr uint32_t magic = 0x48464F4B; // "KOFH"
+    static constexpr uint32_t version = 1;
+    static constexpr const char* defaultLogPath = "frame_checksums.kfh";
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    struct Record {
+        uint32_t frameNumber;
+        uint32_t reserved;
+        uint64_t hash;
+    };
+
+    static inline Mode mode = Mode::Off;
+    static inline std::ofstream log;
+    static inline bool headerWritten = false;
+    // Verify mode, indexed by frame number
+    static inline std::vector<uint64_t> expected = {};
+    static inline std::vector<bool> expectedPresent = {};
+    static inline int mismatches = 0;
+    static inline int firstMismatch = -1;
+    static inline int framesChecked = 0;
+
+    // Tightly packed RGB24, the same bytes a frame BMP is made of
+    static inline std::vector<uint8_t> pixels = {};
+
+    static bool readLog(const std::filesystem::path& path, Header& header, std::vector<Record>& records);
+    static void dumpFrame(int frameNumber, int width, int height);
+};
+
+#endif
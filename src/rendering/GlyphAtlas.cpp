@@ -0,0 +1,194 @@
+#include "GlyphAtlas.h"
+
+#include <algorithm>
+#include "SpriteBatcher.h"
+
+void GlyphAtlas::init(int pageSize, int maxPages) {
+    State& s = state();
+    s.pageSize = std::max(pageSize, 64);
+    s.maxPages = std::max(maxPages, 1);
+}
+
+void GlyphAtlas::destroy() {
+    State& s = state();
+    for (auto& [font, atlas] : s.atlases) {
+        release(atlas);
+    }
+    s.atlases.clear();
+}
+
+void GlyphAtlas::drawText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color) {
+    State& s = state();
+    if (font == nullptr || text.empty()) {
+        return;
+    }
+    FontAtlas& atlas = s.atlases[font];
+    atlas.lastUsed = ++s.useCounter;
+    const bool kerning = TTF_GetFontKerning(font) != 0;
+
+    // TTF_RenderText shifts the whole string right when a glyph reaches left of the start
+    int pen = 0;
+    int leftmost = 0;
+    uint8_t previous = 0;
+    for (const char c : text) {
+        const uint8_t ch = static_cast<uint8_t>(c);
+        const Glyph& glyph = getGlyph(renderer, font, atlas, ch);
+        if (kerning && previous != 0) {
+            pen += TTF_GetFontKerningSizeGlyphs32(font, previous, ch);
+        }
+        leftmost = std::min(leftmost, pen + glyph.minX);
+        pen += glyph.advance;
+        previous = ch;
+    }
+
+    pen = x - leftmost;
+    previous = 0;
+    for (const char c : text) {
+        const uint8_t ch = static_cast<uint8_t>(c);
+        const Glyph& glyph = getGlyph(renderer, font, atlas, ch);
+        if (kerning && previous != 0) {
+            pen += TTF_GetFontKerningSizeGlyphs32(font, previous, ch);
+        }
+        if (glyph.page >= 0) {
+            const Page& page = atlas.pages[glyph.page];
+            const SDL_FRect uv = {
+                glyph.rect.x / static_cast<float>(page.width), glyph.rect.y / static_cast<float>(page.height),
+                glyph.rect.w / static_cast<float>(page.width), glyph.rect.h / static_cast<float>(page.height) };
+            const SDL_Rect dest = { pen + glyph.offsetX, y, glyph.rect.w, glyph.rect.h };
+            SpriteBatcher::add(renderer, page.texture, uv, dest, 0.0f, { 0, 0 }, SDL_FLIP_NONE, color);
+        }
+        pen += glyph.advance;
+        previous = ch;
+    }
+}
+
+int GlyphAtlas::getPageCount() {
+    return state().pageCount;
+}
+
+size_t GlyphAtlas::getTextureBytes() {
+    return state().pageBytes;
+}
+
+const GlyphAtlas::Glyph& GlyphAtlas::getGlyph(SDL_Renderer* renderer, TTF_Font* font, FontAtlas& atlas, uint8_t ch) {
+    Glyph& glyph = atlas.glyphs[ch];
+    if (glyph.loaded) {
+        return glyph;
+    }
+    glyph.loaded = true;
+
+    int minY = 0;
+    int maxX = 0;
+    int maxY = 0;
+    if (TTF_GlyphMetrics32(font, ch, &glyph.minX, &maxX, &minY, &maxY, &glyph.advance) != 0) {
+        return glyph;
+    }
+    // Rendered like a one character string, so the surface is a full line tall with the baseline in place
+    glyph.offsetX = std::min(glyph.minX, 0);
+
+    SDL_Surface* rendered = TTF_RenderGlyph32_Solid(font, ch, { 255, 255, 255, 255 });
+    if (rendered == nullptr) {
+        return glyph;
+    }
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(rendered);
+    if (rgba == nullptr) {
+        return glyph;
+    }
+
+    int page = -1;
+    SDL_Point position{};
+    if (rgba->w > 0 && rgba->h > 0 && place(renderer, font, atlas, rgba->w, rgba->h, page, position)) {
+        glyph.page = page;
+        glyph.rect = { position.x, position.y, rgba->w, rgba->h };
+        SDL_UpdateTexture(atlas.pages[page].texture, &glyph.rect, rgba->pixels, rgba->pitch);
+    }
+    SDL_FreeSurface(rgba);
+    return glyph;
+}
+
+bool GlyphAtlas::place(SDL_Renderer* renderer, TTF_Font* font, FontAtlas& atlas, int width, int height, int& page, SDL_Point& position) {
+    const int paddedWidth = width + padding;
+    const int paddedHeight = height + padding;
+
+    if (!atlas.pages.empty()) {
+        Page& last = atlas.pages.back();
+        if (last.shelfX + paddedWidth > last.width) {
+            last.shelfY += last.shelfHeight;
+            last.shelfX = 0;
+            last.shelfHeight = 0;
+        }
+        if (last.shelfX + paddedWidth <= last.width && last.shelfY + paddedHeight <= last.height) {
+            page = static_cast<int>(atlas.pages.size()) - 1;
+            position = { last.shelfX, last.shelfY };
+            last.shelfX += paddedWidth;
+            last.shelfHeight = std::max(last.shelfHeight, paddedHeight);
+            return true;
+        }
+    }
+
+    if (!addPage(renderer, font, atlas, paddedWidth, paddedHeight)) {
+        return false;
+    }
+    Page& fresh = atlas.pages.back();
+    page = static_cast<int>(atlas.pages.size()) - 1;
+    position = { 0, 0 };
+    fresh.shelfX = paddedWidth;
+    fresh.shelfHeight = paddedHeight;
+    return true;
+}
+
+bool GlyphAtlas::addPage(SDL_Renderer* renderer, TTF_Font* font, FontAtlas& atlas, int minWidth, int minHeight) {
+    State& s = state();
+    if (s.pageCount >= s.maxPages) {
+        evictLeastRecentlyUsed(renderer, font);
+    }
+
+    Page page;
+    // Huge font sizes get a page fitted to the glyph
+    page.width = std::max(s.pageSize, minWidth);
+    page.height = std::max(s.pageSize, minHeight);
+    page.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, page.width, page.height);
+    if (page.texture == nullptr) {
+        return false;
+    }
+    SDL_SetTextureBlendMode(page.texture, SDL_BLENDMODE_BLEND);
+
+    // Texture contents start undefined, the padding between glyphs has to be transparent
+    const std::vector<uint8_t> clear(static_cast<size_t>(page.width) * page.height * 4, 0);
+    SDL_UpdateTexture(page.texture, nullptr, clear.data(), page.width * 4);
+
+    atlas.pages.push_back(page);
+    s.pageCount++;
+    s.pageBytes += static_cast<size_t>(page.width) * page.height * 4;
+    return true;
+}
+
+void GlyphAtlas::evictLeastRecentlyUsed(SDL_Renderer* renderer, TTF_Font* keep) {
+    State& s = state();
+    auto victim = s.atlases.end();
+    for (auto it = s.atlases.begin(); it != s.atlases.end(); ++it) {
+        if (it->first != keep && !it->second.pages.empty() && (victim == s.atlases.end() || it->second.lastUsed < victim->second.lastUsed)) {
+            victim = it;
+        }
+    }
+    // A single font using every page is allowed past the cap, it needs at most 256 glyphs
+    if (victim == s.atlases.end()) {
+        return;
+    }
+    // Quads already queued may point into the pages about to go
+    SpriteBatcher::flush(renderer);
+    release(victim->second);
+    s.atlases.erase(victim);
+}
+
+void GlyphAtlas::release(FontAtlas& atlas) {
+    State& s = state();
+    for (Page& page : atlas.pages) {
+        SDL_DestroyTexture(page.texture);
+        s.pageBytes -= static_cast<size_t>(page.width) * page.height * 4;
+    }
+    s.pageCount -= static_cast<int>(atlas.pages.size());
+    atlas.pages.clear();
+    atlas.glyphs = {};
+}
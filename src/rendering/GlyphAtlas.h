@@ -0,0 +1,80 @@
+#ifndef GLYPHATLAS_H
+#define GLYPHATLAS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SDL2/SDL.h"
+#include "SDL2_ttf/SDL_ttf.h"
+
+// Text drawn from per-font glyph atlases instead of one texture per string
+// Each (font, size) rasterizes a glyph the first time it is drawn, in white, into shelf packed pages.
+// Strings become quads in the SpriteBatcher with the text color as vertex color, so changing text or
+// color never creates a texture. Text is Latin-1 like TTF_RenderText, one glyph per byte.
+// Pages are capped in total, the least recently drawn font gives up its pages when more are needed.
+class GlyphAtlas
+{
+public:
+    static void init(int pageSize, int maxPages);
+    static void destroy();
+
+    // Same placement as TTF_RenderText_Solid's surface drawn with its top left at (x, y)
+    static void drawText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color);
+
+    static int getPageCount();
+    // RGBA bytes of every page
+    static size_t getTextureBytes();
+
+private:
+    static constexpr int padding = 1;
+
+    struct Glyph {
+        bool loaded = false;
+        // -1 when the glyph has no pixels (space) or couldn't be rendered
+        int page = -1;
+        SDL_Rect rect = { 0, 0, 0, 0 };
+        // Where the glyph surface's left edge sits relative to the pen
+        int offsetX = 0;
+        int minX = 0;
+        int advance = 0;
+    };
+
+    struct Page {
+        SDL_Texture* texture = nullptr;
+        int width = 0;
+        int height = 0;
+        int shelfX = 0;
+        int shelfY = 0;
+        int shelfHeight = 0;
+    };
+
+    struct FontAtlas {
+        std::array<Glyph, 256> glyphs = {};
+        std::vector<Page> pages;
+        uint64_t lastUsed = 0;
+    };
+
+    friend class EngineContext;
+
+    struct State {
+        std::unordered_map<TTF_Font*, FontAtlas> atlases = {};
+        int pageSize = 512;
+        int maxPages = 16;
+        int pageCount = 0;
+        size_t pageBytes = 0;
+        uint64_t useCounter = 0;
+    };
+
+    static State& state();
+
+    static const Glyph& getGlyph(SDL_Renderer* renderer, TTF_Font* font, FontAtlas& atlas, uint8_t ch);
+    static bool place(SDL_Renderer* renderer, TTF_Font* font, FontAtlas& atlas, int width, int height, int& page, SDL_Point& position);
+    static bool addPage(SDL_Renderer* renderer, TTF_Font* font, FontAtlas& atlas, int minWidth, int minHeight);
+    static void evictLeastRecentlyUsed(SDL_Renderer* renderer, TTF_Font* keep);
+    static void release(FontAtlas& atlas);
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "ImageCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "SDL2_image/SDL_image.h"
+#include "../utils/HashHelper.h"
+#include "../utils/MappedFile.h"
+#include "../utils/QoiCodec.h"
+
+SDL_Surface* ImageCache::loadSurface(const std::string& imageName, const uint8_t* source, size_t sourceSize, bool& hasAlpha) {
+    if (source == nullptr || sourceSize == 0) {
+        return nullptr;
+    }
+    const uint64_t sourceHash = fnv1a64(source, sourceSize);
+    const std::filesystem::path cachePath = cacheFolder / (imageName + ".qoi");
+
+    if (SDL_Surface* cached = readCache(cachePath, sourceHash, hasAlpha)) {
+        return cached;
+    }
+
+    // Stale or missing entry, decode the source and rebuild it
+    SDL_Surface* decoded = IMG_Load_RW(SDL_RWFromConstMem(source, static_cast<int>(sourceSize)), 1);
+    if (decoded == nullptr) {
+        return nullptr;
+    }
+    hasAlpha = ImageCache::hasAlpha(decoded);
+    // Always RGBA32 so a cache hit and a miss produce the same pixels
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(decoded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(decoded);
+    if (surface == nullptr) {
+        return nullptr;
+    }
+    writeCache(cachePath, sourceHash, hasAlpha, surface);
+    return surface;
+}
+
+bool ImageCache::hasAlpha(SDL_Surface* surface) {
+    return surface->format->Amask != 0 || SDL_HasColorKey(surface);
+}
+
+SDL_Surface* ImageCache::readCache(const std::filesystem::path& cachePath, uint64_t sourceHash, bool& hasAlpha) {
+    MappedFile cached;
+    if (!cached.openReadOnly(cachePath) || cached.size() < sizeof(Header)) {
+        return nullptr;
+    }
+
+    Header header{};
+    std::memcpy(&header, cached.data(), sizeof(Header));
+    if (header.magic != magic || header.version != version || header.sourceHash != sourceHash) {
+        return nullptr;
+    }
+
+    QoiCodec::Image image;
+    if (!QoiCodec::decode(cached.data() + sizeof(Header), cached.size() - sizeof(Header), image)) {
+        return nullptr;
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, static_cast<int>(image.width), static_cast<int>(image.height), 32, SDL_PIXELFORMAT_RGBA32);
+    if (surface == nullptr) {
+        return nullptr;
+    }
+    const size_t rowSize = static_cast<size_t>(image.width) * 4;
+    for (uint32_t y = 0; y < image.height; y++) {
+        std::memcpy(static_cast<uint8_t*>(surface->pixels) + static_cast<size_t>(y) * surface->pitch, image.pixels.data() + y * rowSize, rowSize);
+    }
+    hasAlpha = (header.flags & flagHasAlpha) != 0;
+    return surface;
+}
+
+void ImageCache::writeCache(const std::filesystem::path& cachePath, uint64_t sourceHash, bool hasAlpha, SDL_Surface* surface) {
+    // A read-only install just runs without the cache
+    std::error_code error;
+    std::filesystem::create_directories(cacheFolder, error);
+    if (error) {
+        return;
+    }
+
+    const size_t rowSize = static_cast<size_t>(surface->w) * 4;
+    std::vector<uint8_t> rgba(rowSize * surface->h);
+    SDL_LockSurface(surface);
+    for (int y = 0; y < surface->h; y++) {
+        std::memcpy(rgba.data() + y * rowSize, static_cast<const uint8_t*>(surface->pixels) + static_cast<size_t>(y) * surface->pitch, rowSize);
+    }
+    SDL_UnlockSurface(surface);
+
+    std::vector<uint8_t> bytes(sizeof(Header));
+    const Header header{ magic, version, sourceHash, hasAlpha ? flagHasAlpha : 0u, 0u };
+    std::memcpy(bytes.data(), &header, sizeof(Header));
+    QoiCodec::encode(rgba.data(), static_cast<uint32_t>(surface->w), static_cast<uint32_t>(surface->h), bytes);
+
+    // Write then rename so an interrupted run never leaves a half written entry behind
+    // Instances loading side by side may write the same entry, each thread gets its own temp file
+    std::filesystem::path tempPath = cachePath;
+    tempPath += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, cachePath, error);
+}
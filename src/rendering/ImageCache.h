@@ -0,0 +1,43 @@
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "SDL2/SDL.h"
+
+// Decoded-image cache used by Renderer::loadImages
+// Each image is stored as <cacheFolder>/<name>.qoi, prefixed with a hash of the source file it
+// was decoded from. A matching hash skips the PNG decode, anything else rebuilds the entry.
+class ImageCache
+{
+public:
+    static inline std::filesystem::path cacheFolder = "resources/images/.cache/";
+
+    // source is the encoded image file (PNG), returns an RGBA32 surface owned by the caller or nullptr if it can't be decoded
+    // hasAlpha reports whether the source had transparency, which decides the texture blend mode
+    static SDL_Surface* loadSurface(const std::string& imageName, const uint8_t* source, size_t sourceSize, bool& hasAlpha);
+
+    // Whether a decoded surface has an alpha channel or a color key, like SDL_CreateTextureFromSurface checks
+    static bool hasAlpha(SDL_Surface* surface);
+
+private:
+    static constexpr uint32_t magic = 0x43514F4B; // "KOQC"
+    static constexpr uint32_t version = 2;
+    static constexpr uint32_t flagHasAlpha = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceHash;
+        uint32_t flags;
+        uint32_t reserved;
+    };
+
+    static SDL_Surface* readCache(const std::filesystem::path& cachePath, uint64_t sourceHash, bool& hasAlpha);
+    static void writeCache(const std::filesystem::path& cachePath, uint64_t sourceHash, bool hasAlpha, SDL_Surface* surface);
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include "PixelBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXELBUFFER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // x / 255 rounded, exact for x <= 255 * 255
+    inline uint32_t div255(uint32_t x) {
+        x += 128;
+        return (x + (x >> 8)) >> 8;
+    }
+
+    inline void blendScalar(uint8_t* dst, const uint8_t* src) {
+        const uint32_t alpha = src[3];
+        if (alpha == 0) {
+            return;
+        }
+        const uint32_t inverse = 255 - alpha;
+        dst[0] = static_cast<uint8_t>(div255(src[0] * alpha) + div255(dst[0] * inverse));
+        dst[1] = static_cast<uint8_t>(div255(src[1] * alpha) + div255(dst[1] * inverse));
+        dst[2] = static_cast<uint8_t>(div255(src[2] * alpha) + div255(dst[2] * inverse));
+        dst[3] = static_cast<uint8_t>(alpha + div255(dst[3] * inverse));
+    }
+
+#ifdef PIXELBUFFER_SSE2
+    inline __m128i div255(__m128i x) {
+        x = _mm_add_epi16(x, _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+    }
+
+    // Two pixels widened to 16 bits per channel
+    inline __m128i blendPair(__m128i src, __m128i dst) {
+        const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+        __m128i alpha = _mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3));
+        alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+        // Color lanes get multiplied by alpha, the alpha lane by 255 so it passes through unchanged
+        const __m128i factor = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), _mm_and_si128(alphaLanes, _mm_set1_epi16(255)));
+        return _mm_add_epi16(div255(_mm_mullo_epi16(src, factor)), div255(_mm_mullo_epi16(dst, inverse)));
+    }
+#endif
+}
+
+bool PixelBuffer::init(SDL_Renderer* renderer, int width, int height) {
+    State& s = state();
+    destroy();
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    s.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (s.texture == nullptr) {
+        return false;
+    }
+    // Premultiplied over: dst = src + dst * (1 - src.a)
+    const SDL_BlendMode premultipliedOver = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    if (SDL_SetTextureBlendMode(s.texture, premultipliedOver) != 0) {
+        destroy();
+        return false;
+    }
+
+    s.width = width;
+    s.height = height;
+    for (Canvas& canvas : s.canvases) {
+        canvas.pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+        canvas.minX = canvas.minY = 0;
+        canvas.maxX = canvas.maxY = -1;
+    }
+    return true;
+}
+
+void PixelBuffer::destroy() {
+    State& s = state();
+    if (s.texture != nullptr) {
+        SDL_DestroyTexture(s.texture);
+        s.texture = nullptr;
+    }
+    for (Canvas& canvas : s.canvases) {
+        canvas.pixels.clear();
+        canvas.pixels.shrink_to_fit();
+    }
+    s.width = s.height = 0;
+}
+
+size_t PixelBuffer::getMemoryBytes() {
+    State& s = state();
+    size_t bytes = s.texture != nullptr ? static_cast<size_t>(s.width) * s.height * 4 : 0;
+    for (const Canvas& canvas : s.canvases) {
+        bytes += canvas.pixels.capacity();
+    }
+    return bytes;
+}
+
+bool PixelBuffer::isActive() {
+    return state().texture != nullptr;
+}
+
+void PixelBuffer::blendPixel(int x, int y, SDL_Color color) {
+    State& s = state();
+    if (x < 0 || y < 0 || x >= s.width || y >= s.height || color.a == 0) {
+        return;
+    }
+    Canvas& canvas = s.canvases[s.recordingCanvas];
+    const uint8_t src[4] = { color.r, color.g, color.b, color.a };
+    blendScalar(&canvas.pixels[(static_cast<size_t>(y) * s.width + x) * 4], src);
+    canvas.markDirty(x, y, x, y);
+}
+
+void PixelBuffer::blendSpan(int x, int y, const uint8_t* rgba, int count) {
+    State& s = state();
+    if (y < 0 || y >= s.height) {
+        return;
+    }
+    if (x < 0) {
+        rgba += static_cast<size_t>(-x) * 4;
+        count += x;
+        x = 0;
+    }
+    count = std::min(count, s.width - x);
+    if (count <= 0) {
+        return;
+    }
+    Canvas& canvas = s.canvases[s.recordingCanvas];
+    blendRow(&canvas.pixels[(static_cast<size_t>(y) * s.width + x) * 4], rgba, count);
+    canvas.markDirty(x, y, x + count - 1, y);
+}
+
+void PixelBuffer::blendRow(uint8_t* dst, const uint8_t* src, int count) {
+    int i = 0;
+#ifdef PIXELBUFFER_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        const __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        const __m128i dest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i * 4));
+        const __m128i low = blendPair(_mm_unpacklo_epi8(source, zero), _mm_unpacklo_epi8(dest, zero));
+        const __m128i high = blendPair(_mm_unpackhi_epi8(source, zero), _mm_unpackhi_epi8(dest, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_packus_epi16(low, high));
+    }
+#endif
+    for (; i < count; i++) {
+        blendScalar(dst + i * 4, src + i * 4);
+    }
+}
+
+void PixelBuffer::swap() {
+    State& s = state();
+    s.recordingCanvas ^= 1;
+    s.canvases[s.recordingCanvas].clear();
+}
+
+bool PixelBuffer::present(SDL_Renderer* renderer) {
+    State& s = state();
+    Canvas& canvas = s.canvases[s.recordingCanvas ^ 1];
+    if (s.texture == nullptr || canvas.minX > canvas.maxX) {
+        return false;
+    }
+    const SDL_Rect dirty = { canvas.minX, canvas.minY, canvas.maxX - canvas.minX + 1, canvas.maxY - canvas.minY + 1 };
+    uint8_t* first = &canvas.pixels[(static_cast<size_t>(dirty.y) * s.width + dirty.x) * 4];
+
+    SDL_UpdateTexture(s.texture, &dirty, first, s.width * 4);
+    SDL_RenderCopy(renderer, s.texture, &dirty, &dirty);
+    return true;
+}
+
+void PixelBuffer::Canvas::clear() {
+    // Empty before init() and after destroy()
+    if (minX > maxX || pixels.empty()) {
+        return;
+    }
+    // Only the dirty region can be non-zero
+    const size_t rowBytes = static_cast<size_t>(maxX - minX + 1) * 4;
+    for (int row = minY; row <= maxY; row++) {
+        std::memset(&pixels[(static_cast<size_t>(row) * state().width + minX) * 4], 0, rowBytes);
+    }
+    minX = minY = 0;
+    maxX = maxY = -1;
+}
+
+void PixelBuffer::Canvas::markDirty(int x0, int y0, int x1, int y1) {
+    if (minX > maxX) {
+        minX = x0;
+        minY = y0;
+        maxX = x1;
+        maxY = y1;
+        return;
+    }
+    minX = std::min(minX, x0);
+    minY = std::min(minY, y0);
+    maxX = std::max(maxX, x1);
+    maxY = std::max(maxY, y1);
+}
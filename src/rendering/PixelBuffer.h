@@ -0,0 +1,64 @@
+#ifndef PIXELBUFFER_H
+#define PIXELBUFFER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "SDL2/SDL.h"
+
+// CPU side target for Image.DrawPixel/DrawPixels, composited over the frame once per present
+// Pixels are blended into a premultiplied RGBA buffer in call order, which is the same as blending each
+// one straight onto the frame, then the touched region is uploaded through a streaming texture and drawn
+// with a premultiplied "over" blend mode.
+class PixelBuffer
+{
+public:
+    // Returns false if the renderer can't do the blend mode, callers then keep drawing points
+    static bool init(SDL_Renderer* renderer, int width, int height);
+    static void destroy();
+    static bool isActive();
+    // Streaming texture plus both canvases
+    static size_t getMemoryBytes();
+
+    static void blendPixel(int x, int y, SDL_Color color);
+    // count straight (not premultiplied) RGBA pixels starting at (x, y), clipped to the buffer
+    static void blendSpan(int x, int y, const uint8_t* rgba, int count);
+
+    // Blends go to one canvas while present() draws the other, swapped together with the render queues
+    // The canvas that becomes the recording one is cleared here, so a presented canvas can be drawn again
+    static void swap();
+
+    // Draws whatever was blended into the presented canvas, call at render scale 1
+    // Returns false if there was nothing to draw
+    static bool present(SDL_Renderer* renderer);
+
+    // dst = premultiply(src) + dst * (255 - src.a) / 255 per channel, SSE2 when available
+    static void blendRow(uint8_t* dst, const uint8_t* src, int count);
+
+private:
+    struct Canvas {
+        std::vector<uint8_t> pixels;
+        // Touched region, empty when minX > maxX, reset by init()
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+
+        void markDirty(int x0, int y0, int x1, int y1);
+        void clear();
+    };
+
+    friend class EngineContext;
+
+    struct State {
+        SDL_Texture* texture = nullptr;
+        Canvas canvases[2] = {};
+        int recordingCanvas = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    static State& state();
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include "../utils/Logger.h"
+#include "../utils/RadixSort.h"
+
+namespace {
+    // Shared by every instance's queue, one warning per process is enough to spot the layering bug
+    std::atomic<bool> clampWarned{ false };
+}
+
+void RenderQueue::push(const ImageRenderRequest& request, RenderLayer layer, int sortingOrder, uint16_t texture) {
+    // The index field can't address more, anything past it is dropped
+    if (requests.size() > indexMask) {
+        return;
+    }
+    if ((sortingOrder < -orderBias || sortingOrder > orderBias - 1) && !clampWarned.exchange(true)) {
+        Logger::warning(Logger::Render, "sortingOrder ", sortingOrder, " is outside [", -orderBias, ", ", orderBias - 1,
+            "] and was clamped, draws past the limit share one order");
+    }
+    const uint64_t order = static_cast<uint64_t>(std::clamp(sortingOrder, -orderBias, orderBias - 1) + orderBias);
+    const uint64_t key = (static_cast<uint64_t>(layer) << layerShift)
+        | (order << orderShift)
+        | (static_cast<uint64_t>(texture) << textureShift)
+        | static_cast<uint64_t>(requests.size());
+
+    requests.push_back(request);
+    keys.push_back(key);
+}
+
+void RenderQueue::sort() {
+    // Keys are pushed in submission order and the sort is stable, so the index bytes never need a pass
+    radixSortKeys(keys, scratch, indexBits / 8);
+}
+
+void RenderQueue::clear() {
+    requests.clear();
+    keys.clear();
+    marked = false;
+}
+
+void RenderQueue::mark() {
+    markedKeys.assign(keys.begin(), keys.end());
+    markedRequests = requests.size();
+    marked = true;
+}
+
+void RenderQueue::rewind() {
+    if (!marked) {
+        return;
+    }
+    keys.assign(markedKeys.begin(), markedKeys.end());
+    requests.resize(markedRequests);
+}
@@ -0,0 +1,71 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RenderRequests.h"
+
+enum class RenderLayer : uint8_t {
+    World = 0,
+    UI = 1
+};
+
+// One frame of image draws, world and UI together, ordered by a packed 64-bit key per request:
+//   layer (4 bits) | sortingOrder + bias (20 bits) | texture (16 bits) | submission index (24 bits)
+// The submission index keeps equal keys in queue order, like the std::stable_sort this replaces.
+// Storage is kept across frames, so a steady frame queues and sorts without allocating.
+class RenderQueue
+{
+public:
+    // sortingOrder is clamped to the 20-bit range (warned about once), texture is 0 unless draws should be grouped by texture
+    void push(const ImageRenderRequest& request, RenderLayer layer, int sortingOrder, uint16_t texture);
+    void sort();
+    void clear();
+
+    // Remembers the requests queued so far, rewind() then drops everything pushed after
+    // and undoes any retain() or sort() since, so the frame can be culled and drawn again
+    void mark();
+    void rewind();
+    bool isMarked() const { return marked; }
+
+    // Drops the requests keep() rejects, keeping the rest in order, returns how many were dropped
+    template <typename Keep>
+    size_t retain(Keep keep) {
+        size_t kept = 0;
+        for (const uint64_t key : keys) {
+            if (keep(requests[key & indexMask], static_cast<RenderLayer>(key >> layerShift))) {
+                keys[kept++] = key;
+            }
+        }
+        const size_t dropped = keys.size() - kept;
+        keys.resize(kept);
+        return dropped;
+    }
+
+    size_t size() const { return keys.size(); }
+    // Valid after sort()
+    const ImageRenderRequest& sorted(size_t i) const { return requests[keys[i] & indexMask]; }
+    RenderLayer layer(size_t i) const { return static_cast<RenderLayer>(keys[i] >> layerShift); }
+
+private:
+    static constexpr int indexBits = 24;
+    static constexpr int textureBits = 16;
+    static constexpr int orderBits = 20;
+    static constexpr int textureShift = indexBits;
+    static constexpr int orderShift = textureShift + textureBits;
+    static constexpr int layerShift = orderShift + orderBits;
+
+    static constexpr uint64_t indexMask = (uint64_t(1) << indexBits) - 1;
+    static constexpr int orderBias = 1 << (orderBits - 1);
+
+    std::vector<ImageRenderRequest> requests;
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> scratch;
+    std::vector<uint64_t> markedKeys;
+    size_t markedRequests = 0;
+    bool marked = false;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef RENDERSTATS_H
+#define RENDERSTATS_H
+
+#include <atomic>
+
+// Per-frame renderer counters, the previous frame's totals are what Lua and tools read
+class RenderStats
+{
+public:
+    // Counted by the renderer of the running instance
+    struct State {
+        // Calls that reach the SDL renderer (copies, geometry submissions, points)
+        int drawCalls = 0;
+        // SDL_RenderGeometry submissions made by the SpriteBatcher
+        int batches = 0;
+        // Images and UI images drawn, batched or not
+        int sprites = 0;
+        // Changes of texture between consecutive draws, what atlas packing keeps low
+        int textureSwitches = 0;
+        // World images dropped for being outside the camera view, see SpriteCuller
+        int culled = 0;
+        // Requests in the frame being presented, counted before culling
+        int queuedImages = 0;
+        int queuedText = 0;
+        int queuedPixels = 0;
+
+        // Written by whichever thread renders, read from Lua on the simulation thread
+        std::atomic<int> lastDrawCalls = 0;
+        std::atomic<int> lastBatches = 0;
+        std::atomic<int> lastSprites = 0;
+        std::atomic<int> lastTextureSwitches = 0;
+        std::atomic<int> lastCulled = 0;
+        std::atomic<int> lastQueuedImages = 0;
+        std::atomic<int> lastQueuedText = 0;
+        std::atomic<int> lastQueuedPixels = 0;
+        // Time spent in the present of the previous frame, capture included
+        std::atomic<float> lastPresentMs = 0.0f;
+    };
+
+    static State& state();
+
+    static void endFrame() {
+        State& s = state();
+        s.lastDrawCalls = s.drawCalls;
+        s.lastBatches = s.batches;
+        s.lastSprites = s.sprites;
+        s.lastTextureSwitches = s.textureSwitches;
+        s.lastCulled = s.culled;
+        s.lastQueuedImages = s.queuedImages;
+        s.lastQueuedText = s.queuedText;
+        s.lastQueuedPixels = s.queuedPixels;
+        s.drawCalls = 0;
+        s.batches = 0;
+        s.sprites = 0;
+        s.textureSwitches = 0;
+        s.culled = 0;
+        s.queuedImages = 0;
+        s.queuedText = 0;
+        s.queuedPixels = 0;
+    }
+
+    static int getDrawCalls() { return state().lastDrawCalls; }
+    static int getBatches() { return state().lastBatches; }
+    static int getSprites() { return state().lastSprites; }
+    static int getTextureSwitches() { return state().lastTextureSwitches; }
+    static int getCulled() { return state().lastCulled; }
+    static int getQueuedImages() { return state().lastQueuedImages; }
+    static int getQueuedText() { return state().lastQueuedText; }
+    static int getQueuedPixels() { return state().lastQueuedPixels; }
+    static float getPresentMs() { return state().lastPresentMs; }
+};
+
+#endif
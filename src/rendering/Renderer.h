@@ -2,47 +2,94 @@
 #define RENDERER_H
 
 #include "SDL2/SDL.h"
+#include <deque>
+#include <mutex>
+#include <string_view>
 #include <glm/ext/vector_int2.hpp>
 #include <glm/ext/vector_float2.hpp>
 #include "../external_helpers/Helper.h"
 #include "../databases/ResourcesDB.h"
+#include "lua.hpp"
 #include "FontDB.h"
 #include "RenderRequests.h"
+#include "RenderQueue.h"
+#include "Sprite.h"
+#include "TextureAtlas.h"
 
 struct Color {
     int r, g, b, a;
 };
 
+// Everything Lua queues during one frame
+struct RenderFrame {
+    // World and UI images, see RenderQueue for the ordering
+    RenderQueue images;
+    std::vector<TextRenderRequest> text;
+    std::vector<PixelRenderRequest> pixels;
+    // Names behind missingSprite handles queued this frame
+    std::vector<std::string> missingImages;
+    glm::vec2 cameraPosition = { 0, 0 };
+    float zoomFactor = 1.0f;
+
+    // What the frame held before its first render pass, valid while images.isMarked()
+    struct Mark {
+        size_t text = 0;
+        size_t pixels = 0;
+        size_t missingImages = 0;
+        glm::vec2 cameraPosition = { 0, 0 };
+        float zoomFactor = 1.0f;
+    } mark;
+};
+
 class Renderer
 {
 public:
     // ---------- Initialization Functions ----------
 
-    void init(const ResourcesDB& configDB);
+    // headless renders into an offscreen surface through the software renderer, no window is opened
+    void init(const ResourcesDB& configDB, bool headless = false);
     static void shutDown();
     static Renderer* getInstance();
     static SDL_Renderer* getRenderer();
 
+    // Cached Text.Draw textures, bytes estimated at 4 per pixel
+    static size_t getTextCacheCount();
+    static size_t getTextCacheBytes();
+
     // ---------- Core Rendering Functions ----------
 
+    // Presents the frame handed over by the last swapFrames
     static void render();
+    // Hands the recorded frame to render() and starts recording an empty one, see FramePipeline
+    static void swapFrames();
+    // Draws and camera changes between these two go to the frame render() presents next and only last
+    // for that render, the frame is drawn again without them. Used for OnRender with a fixed timestep
+    static void beginRenderPass();
+    static void endRenderPass();
 
     // ---------- Render Request Functions ----------
 
+    // Image names are taken as const char* so queuing a draw from Lua never builds a std::string
+
     // Image.Draw
-    static void queueImage(const std::string& image, const float x, const float y);
+    static void queueImage(const char* image, const float x, const float y);
     // Image.DrawEx: color + tint/alpha + sortingOrder
-    static void queueImageExtended(const std::string& image, const float x, const float y, const float rotationDegrees, const float scaleX, const float scaleY, const float pivotX, const float pivotY, float r, float g, float b, float a, float sortingOrder);
+    static void queueImageExtended(const char* image, const float x, const float y, const float rotationDegrees, const float scaleX, const float scaleY, const float pivotX, const float pivotY, float r, float g, float b, float a, float sortingOrder);
 
     // Image.DrawUI
-    static void queueUI(const std::string& image, const float x, const float y);
+    static void queueUI(const char* image, const float x, const float y);
     // Image.DrawUIEx: color + tint/alpha + sortingOrder
-    static void queueUIExtended(const std::string& image, const float x, const float y, const float r, const float g, const float b, const float a, const float sortingOrder);
+    static void queueUIExtended(const char* image, const float x, const float y, const float r, const float g, const float b, const float a, const float sortingOrder);
 
     // Text.Draw
     static void queueText(const std::string& text, const float x, const float y, const std::string& fontName, const float fontSize, const float r, const float g, const float b, const float a);
     // Image.DrawPixel
     static void queuePixel(const float x, const float y, const float r, const float g, const float b, const float a);
+    // Image.DrawPixels(x, y, width, pixels): pixels is an array of 0xRRGGBBAA, row by row from (x, y)
+    static int queuePixels(lua_State* L);
+
+    // Image.DefineSprite: names a sub-rectangle (in pixels) of a loaded image, drawable with every Image.Draw* function
+    static void defineSprite(const std::string& name, const std::string& image, const float x, const float y, const float width, const float height);
 
     // -------------- Utility Functions -------------
 
@@ -54,26 +101,71 @@ public:
     static float getCameraZoom();
 
 private:
-    static inline Renderer* instance = nullptr;
-    static inline SDL_Window* window = nullptr;
-    static inline SDL_Renderer* renderer = nullptr;
-    static inline Color clearColor = { 255, 255, 255, 255 };
-
-    static inline glm::ivec2 resolution = {0, 0};
-    static inline glm::vec2 cameraPosition = {0, 0};
-    static inline float zoomFactor = 1.0f;
-
-    static inline FontDB* fontDB = nullptr;
+    friend class EngineContext;
+
+    struct State {
+        Renderer* instance = nullptr;
+        SDL_Window* window = nullptr;
+        SDL_Renderer* renderer = nullptr;
+        // Headless render target
+        SDL_Surface* offscreenTarget = nullptr;
+        Color clearColor = { 255, 255, 255, 255 };
+
+        glm::ivec2 resolution = {0, 0};
+
+        FontDB* fontDB = nullptr;
+
+        // Decoded images are cached as QOI under imagePath/.cache, see ImageCache
+        bool useImageCache = true;
+        // Images/UI go through SpriteBatcher instead of one SDL_RenderCopyEx each
+        bool spriteBatching = false;
+        // Images are packed into shared atlas pages, see TextureAtlas
+        bool useTextureAtlas = true;
+        int atlasPageSize = 2048;
+        // Text is drawn glyph by glyph from GlyphAtlas
+        bool useGlyphAtlas = true;
+        // World images outside the camera view are dropped before sorting, see SpriteCuller
+        bool spriteCulling = true;
+        int cullGridThreshold = 4096;
+        // Group draws with equal sortingOrder by texture, changes the order such draws overlap in
+        bool sortByTexture = false;
+        // Last texture drawn, for counting texture switches
+        SDL_Texture* lastTexture = nullptr;
+
+        // One frame is recorded while the other is rendered
+        RenderFrame frames[2];
+        int recordingFrame = 0;
+        // Between beginRenderPass and endRenderPass, recording() is the presented frame
+        bool inRenderPass = false;
+        // One unpacked row of an Image.DrawPixels call
+        std::vector<uint8_t> pixelRow = {};
+
+        // Sprite handles index sprites, spriteIds views the names kept alive by spriteNames
+        std::vector<Sprite> sprites = {};
+        std::deque<std::string> spriteNames = {};
+        std::unordered_map<std::string_view, uint32_t> spriteIds = {};
+        // Image.DefineSprite can grow sprites while a pipelined render reads it
+        std::mutex spritesMutex;
+        // Only used when the glyph atlas is off, one texture per (text, font, size, color)
+        std::unordered_map<TextRenderRequest, SDL_Texture*, TextRenderRequestHash> textTextureCache = {};
+        size_t textTextureBytes = 0;
+        // The whole cache is evicted when it reaches this many textures, 0 keeps every texture
+        int textCacheMaxEntries = 1024;
+        // Extra instances present without Helper, its frame number and captures are the primary instance's, see EngineContext
+        bool throughHelper = true;
+
+        State() = default;
+        State(const State&) = delete;
+        State& operator=(const State&) = delete;
+        // Destroying the SDL renderer takes every texture made from it along
+        ~State();
+    };
+
+    static State& state();
 
     static inline std::string imagePath = "resources/images/";
-
-    static inline std::vector<ImageRenderRequest> imageRenderQueue = {};
-    static inline std::vector<UIRenderRequest> UIRenderQueue = {};
-    static inline std::vector<TextRenderRequest> textRenderQueue = {};
-    static inline std::vector<PixelRenderRequest> pixelRenderQueue = {};
-
-    static inline std::unordered_map<std::string, SDL_Texture*> textureCache = {};
-    static inline std::unordered_map<TextRenderRequest, SDL_Texture*, TextRenderRequestHash> textTextureCache = {};
+    // Handles with this bit set name an image that doesn't exist, reported when the draw is rendered
+    static constexpr uint32_t missingSprite = 0x80000000u;
 
     // ---------- Initialization Functions ----------
 
@@ -83,15 +175,23 @@ private:
 
     // ---------- Core Rendering Functions ----------
 
-    static void renderImage(ImageRenderRequest& request);
-    static void renderUI(UIRenderRequest& request);
+    static void renderImage(const ImageRenderRequest& request);
+    static void renderUI(const ImageRenderRequest& request);
     static void renderText(TextRenderRequest& request);
     static void renderPixel(PixelRenderRequest& request);
     static void clear();
+    static RenderFrame& recording();
+    static RenderFrame& presenting();
 
     // -------------- Utility Functions -------------
 
-    static SDL_Texture* getTexture(const std::string& image);
+    static const Sprite& getSprite(const std::string& image);
+    static const Sprite& getSprite(uint32_t handle);
+    static uint32_t findSprite(const char* image);
+    static void setSprite(const std::string& name, const Sprite& sprite);
+    static void queueSprite(const char* image, RenderLayer layer, ImageRenderRequest request, int sortingOrder);
+    static TextureAtlas::Image loadImage(const std::string& imageName, const uint8_t* source, size_t sourceSize);
+    static void countTextureSwitch(SDL_Texture* texture);
     static SDL_Texture* getTexture(const TextRenderRequest& request);
 
     static void setRenderScale(float scaleFactor);
@@ -0,0 +1,17 @@
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include <cstdint>
+#include "SDL2/SDL.h"
+
+// A drawable image: the texture holding it and where inside that texture it lives
+struct Sprite {
+    SDL_Texture* texture = nullptr;
+    SDL_Rect source = { 0, 0, 0, 0 };
+    // source normalized to the texture size, for batched geometry
+    SDL_FRect uv = { 0.0f, 0.0f, 1.0f, 1.0f };
+    // Small per-texture number for grouping draws in the sort key, 0 for no texture
+    uint16_t textureId = 0;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "SpriteBatcher.h"
+
+#include <cmath>
+#include <utility>
+#include "RenderStats.h"
+
+void SpriteBatcher::add(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_FRect& uv, const SDL_Rect& dest, float angleDegrees, const SDL_Point& center, SDL_RendererFlip flip, SDL_Color color) {
+    State& s = state();
+    if (texture != s.batchTexture || s.vertices.size() >= maxSpritesPerBatch * 4) {
+        flush(renderer);
+        s.batchTexture = texture;
+    }
+    if (s.vertices.capacity() == 0) {
+        s.vertices.reserve(maxSpritesPerBatch * 4);
+    }
+
+    float u0 = uv.x;
+    float u1 = uv.x + uv.w;
+    float v0 = uv.y;
+    float v1 = uv.y + uv.h;
+    if (flip & SDL_FLIP_HORIZONTAL) {
+        std::swap(u0, u1);
+    }
+    if (flip & SDL_FLIP_VERTICAL) {
+        std::swap(v0, v1);
+    }
+
+    // Corners relative to the pivot, rotated clockwise like SDL_RenderCopyEx
+    const float pivotX = static_cast<float>(dest.x + center.x);
+    const float pivotY = static_cast<float>(dest.y + center.y);
+    const float left = static_cast<float>(-center.x);
+    const float top = static_cast<float>(-center.y);
+    const float right = left + static_cast<float>(dest.w);
+    const float bottom = top + static_cast<float>(dest.h);
+
+    float cosA = 1.0f;
+    float sinA = 0.0f;
+    if (angleDegrees != 0.0f) {
+        const double radians = angleDegrees * (M_PI / 180.0);
+        cosA = static_cast<float>(std::cos(radians));
+        sinA = static_cast<float>(std::sin(radians));
+    }
+
+    const auto corner = [&](float x, float y, float u, float v) {
+        SDL_Vertex vertex;
+        vertex.position = { pivotX + x * cosA - y * sinA, pivotY + x * sinA + y * cosA };
+        vertex.color = color;
+        vertex.tex_coord = { u, v };
+        s.vertices.push_back(vertex);
+    };
+    corner(left, top, u0, v0);
+    corner(right, top, u1, v0);
+    corner(right, bottom, u1, v1);
+    corner(left, bottom, u0, v1);
+}
+
+void SpriteBatcher::flush(SDL_Renderer* renderer) {
+    State& s = state();
+    if (s.vertices.empty()) {
+        return;
+    }
+
+    const int spriteCount = static_cast<int>(s.vertices.size() / 4);
+    if (s.indices.empty()) {
+        s.indices.reserve(maxSpritesPerBatch * 6);
+        for (int i = 0; i < maxSpritesPerBatch; i++) {
+            const int first = i * 4;
+            s.indices.insert(s.indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+        }
+    }
+
+    SDL_RenderGeometry(renderer, s.batchTexture, s.vertices.data(), static_cast<int>(s.vertices.size()), s.indices.data(), spriteCount * 6);
+    RenderStats::State& stats = RenderStats::state();
+    stats.drawCalls++;
+    stats.batches++;
+
+    s.vertices.clear();
+    s.batchTexture = nullptr;
+}
@@ -0,0 +1,33 @@
+#ifndef SPRITEBATCHER_H
+#define SPRITEBATCHER_H
+
+#include <vector>
+#include "SDL2/SDL.h"
+
+// Collects textured quads and submits consecutive quads sharing a texture as one SDL_RenderGeometry call
+// Tint/alpha travel as vertex colors, rotation/pivot/flip are applied on the CPU, so textures are never modified
+class SpriteBatcher
+{
+public:
+    // Same meaning as the SDL_RenderCopyEx arguments, uv is the normalized source region
+    static void add(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_FRect& uv, const SDL_Rect& dest, float angleDegrees, const SDL_Point& center, SDL_RendererFlip flip, SDL_Color color);
+
+    // Submits whatever is pending, call before any state change (render scale, non-batched draws)
+    static void flush(SDL_Renderer* renderer);
+
+private:
+    static constexpr int maxSpritesPerBatch = 8192;
+
+    friend class EngineContext;
+
+    struct State {
+        SDL_Texture* batchTexture = nullptr;
+        std::vector<SDL_Vertex> vertices = {};
+        // Fixed quad pattern, built once for the largest batch
+        std::vector<int> indices = {};
+    };
+
+    static State& state();
+};
+
+#endif
@@ -0,0 +1,171 @@
+#include "SpriteCuller.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr float pixelsPerUnit = 100.0f;
+}
+
+size_t SpriteCuller::cull(RenderQueue& queue, const std::vector<Sprite>& sprites, uint32_t missingSprite, const View& view, size_t gridThreshold) {
+    State& s = state();
+    const size_t count = queue.size();
+    const auto isWorldSprite = [missingSprite](const ImageRenderRequest& request, RenderLayer layer) {
+        return layer == RenderLayer::World && (request.sprite & missingSprite) == 0;
+    };
+
+    size_t worldCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        worldCount += queue.layer(i) == RenderLayer::World ? 1 : 0;
+    }
+
+    if (worldCount == 0) {
+        return 0;
+    }
+    if (worldCount < gridThreshold) {
+        return queue.retain([&](const ImageRenderRequest& request, RenderLayer layer) {
+            return !isWorldSprite(request, layer) || isVisible(request, sprites[request.sprite], view);
+        });
+    }
+
+    // Coarse pass: bin sprites by pivot over the area they cover, then settle whole cells at once
+    s.boundsScratch.resize(count);
+    float minX = INFINITY;
+    float minY = INFINITY;
+    float maxX = -INFINITY;
+    float maxY = -INFINITY;
+    for (size_t i = 0; i < count; i++) {
+        const ImageRenderRequest& request = queue.sorted(i);
+        if (!isWorldSprite(request, queue.layer(i))) {
+            continue;
+        }
+        const Bounds& b = s.boundsScratch[i] = bounds(request, sprites[request.sprite], view);
+        minX = std::min(minX, b.anchorX);
+        minY = std::min(minY, b.anchorY);
+        maxX = std::max(maxX, b.anchorX);
+        maxY = std::max(maxY, b.anchorY);
+    }
+
+    // Nothing but missing images, which are never culled
+    if (minX > maxX) {
+        return 0;
+    }
+
+    // About 16 sprites per cell on average
+    const int gridSize = std::clamp(static_cast<int>(std::sqrt(static_cast<float>(worldCount) / 16.0f)), 1, maxGridSize);
+    const float cellWidth = std::max((maxX - minX) / gridSize, 1.0f);
+    const float cellHeight = std::max((maxY - minY) / gridSize, 1.0f);
+
+    s.cells.assign(static_cast<size_t>(gridSize) * gridSize, Cell{});
+    s.cellOfRequest.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        if (!isWorldSprite(queue.sorted(i), queue.layer(i))) {
+            continue;
+        }
+        const Bounds& b = s.boundsScratch[i];
+        const int cellX = std::min(static_cast<int>((b.anchorX - minX) / cellWidth), gridSize - 1);
+        const int cellY = std::min(static_cast<int>((b.anchorY - minY) / cellHeight), gridSize - 1);
+        const uint32_t cellIndex = static_cast<uint32_t>(cellY * gridSize + cellX);
+        s.cellOfRequest[i] = cellIndex;
+
+        Cell& cell = s.cells[cellIndex];
+        cell.occupied = true;
+        cell.maxRadius = std::max(cell.maxRadius, b.radius);
+        cell.allPivotsInside = cell.allPivotsInside && b.pivotInside;
+    }
+
+    s.cellStates.assign(s.cells.size(), CellState::Test);
+    for (int cellY = 0; cellY < gridSize; cellY++) {
+        for (int cellX = 0; cellX < gridSize; cellX++) {
+            const size_t cellIndex = static_cast<size_t>(cellY) * gridSize + cellX;
+            const Cell& cell = s.cells[cellIndex];
+            if (!cell.occupied) {
+                continue;
+            }
+            const float left = minX + cellX * cellWidth;
+            const float top = minY + cellY * cellHeight;
+            const float right = left + cellWidth;
+            const float bottom = top + cellHeight;
+
+            // Even the largest sprite in the cell, at any rotation, can't reach the view
+            const float reach = cell.maxRadius + margin;
+            if (right + reach < 0.0f || left - reach > view.width || bottom + reach < 0.0f || top - reach > view.height) {
+                s.cellStates[cellIndex] = CellState::Culled;
+            }
+            // Every pivot is well inside the view and lies on its sprite
+            else if (cell.allPivotsInside && left >= margin && right <= view.width - margin && top >= margin && bottom <= view.height - margin) {
+                s.cellStates[cellIndex] = CellState::Visible;
+            }
+        }
+    }
+
+    size_t i = 0;
+    return queue.retain([&](const ImageRenderRequest& request, RenderLayer layer) {
+        const size_t index = i++;
+        if (!isWorldSprite(request, layer)) {
+            return true;
+        }
+        switch (s.cellStates[s.cellOfRequest[index]]) {
+        case CellState::Culled:
+            return false;
+        case CellState::Visible:
+            return true;
+        default:
+            return isVisible(request, sprites[request.sprite], view);
+        }
+    });
+}
+
+SpriteCuller::Bounds SpriteCuller::bounds(const ImageRenderRequest& request, const Sprite& sprite, const View& view) {
+    // Same integer sizes as renderImage
+    const int width = static_cast<int>(sprite.source.w * std::abs(request.scaleX));
+    const int height = static_cast<int>(sprite.source.h * std::abs(request.scaleY));
+    const float pivotX = static_cast<float>(static_cast<int>(request.pivotX * width));
+    const float pivotY = static_cast<float>(static_cast<int>(request.pivotY * height));
+
+    const float farX = std::max(std::abs(pivotX), std::abs(width - pivotX));
+    const float farY = std::max(std::abs(pivotY), std::abs(height - pivotY));
+
+    Bounds b;
+    b.anchorX = (request.x - view.cameraX) * pixelsPerUnit + view.width * 0.5f;
+    b.anchorY = (request.y - view.cameraY) * pixelsPerUnit + view.height * 0.5f;
+    b.radius = std::sqrt(farX * farX + farY * farY);
+    b.pivotInside = request.pivotX >= 0.0f && request.pivotX <= 1.0f && request.pivotY >= 0.0f && request.pivotY <= 1.0f;
+    return b;
+}
+
+bool SpriteCuller::isVisible(const ImageRenderRequest& request, const Sprite& sprite, const View& view) {
+    const int width = static_cast<int>(sprite.source.w * std::abs(request.scaleX));
+    const int height = static_cast<int>(sprite.source.h * std::abs(request.scaleY));
+    const float pivotX = static_cast<float>(static_cast<int>(request.pivotX * width));
+    const float pivotY = static_cast<float>(static_cast<int>(request.pivotY * height));
+
+    const float anchorX = (request.x - view.cameraX) * pixelsPerUnit + view.width * 0.5f;
+    const float anchorY = (request.y - view.cameraY) * pixelsPerUnit + view.height * 0.5f;
+
+    // Rect corners relative to the pivot, rotated the way SDL_RenderCopyEx rotates them
+    float left = -pivotX;
+    float top = -pivotY;
+    float right = width - pivotX;
+    float bottom = height - pivotY;
+    if (request.rotationDegrees % 360 != 0) {
+        const double radians = request.rotationDegrees * (M_PI / 180.0);
+        const float c = static_cast<float>(std::cos(radians));
+        const float s = static_cast<float>(std::sin(radians));
+        const float xs[4] = { left, right, right, left };
+        const float ys[4] = { top, top, bottom, bottom };
+        left = top = INFINITY;
+        right = bottom = -INFINITY;
+        for (int corner = 0; corner < 4; corner++) {
+            const float x = xs[corner] * c - ys[corner] * s;
+            const float y = xs[corner] * s + ys[corner] * c;
+            left = std::min(left, x);
+            right = std::max(right, x);
+            top = std::min(top, y);
+            bottom = std::max(bottom, y);
+        }
+    }
+
+    return anchorX + right > -margin && anchorX + left < view.width + margin
+        && anchorY + bottom > -margin && anchorY + top < view.height + margin;
+}
@@ -0,0 +1,69 @@
+#ifndef SPRITECULLER_H
+#define SPRITECULLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RenderQueue.h"
+#include "Sprite.h"
+
+// Drops world images that can't touch the camera view before they are sorted and drawn
+// Works in the same unscaled pixel space as Renderer::renderImage, where the view is
+// [0, resolution / zoom] and a sprite is its scaled rect rotated about its pivot.
+class SpriteCuller
+{
+public:
+    struct View {
+        float cameraX;
+        float cameraY;
+        float width;  // resolution.x / zoom
+        float height; // resolution.y / zoom
+    };
+
+    // Returns the number of requests culled, UI requests and missing images are always kept
+    // Queues with at least gridThreshold world images are classified cell by cell first
+    static size_t cull(RenderQueue& queue, const std::vector<Sprite>& sprites, uint32_t missingSprite, const View& view, size_t gridThreshold);
+
+private:
+    // renderImage truncates to whole pixels, so bounds are widened a little to stay conservative
+    static constexpr float margin = 2.0f;
+    static constexpr int maxGridSize = 128;
+
+    struct Bounds {
+        float anchorX;
+        float anchorY;
+        // Distance from the pivot to the farthest corner, bounds the sprite at any rotation
+        float radius;
+        // The pivot lies on the sprite, so a visible pivot means a visible sprite
+        bool pivotInside;
+    };
+
+    enum class CellState : uint8_t {
+        Culled,
+        Visible,
+        Test
+    };
+
+    struct Cell {
+        float maxRadius = 0.0f;
+        bool allPivotsInside = true;
+        bool occupied = false;
+    };
+
+    static Bounds bounds(const ImageRenderRequest& request, const Sprite& sprite, const View& view);
+    static bool isVisible(const ImageRenderRequest& request, const Sprite& sprite, const View& view);
+
+    friend class EngineContext;
+
+    struct State {
+        std::vector<Bounds> boundsScratch = {};
+        std::vector<uint32_t> cellOfRequest = {};
+        std::vector<Cell> cells = {};
+        std::vector<CellState> cellStates = {};
+    };
+
+    static State& state();
+};
+
+#endif
@@ -0,0 +1,280 @@
+#include "StatsOverlay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "lua.hpp"
+#include "LuaBridge/LuaBridge.h"
+#include "../actors/ActorsGuild.h"
+#include "../actors/ComponentManager.h"
+#include "../utils/AllocationTracker.h"
+#include "RenderStats.h"
+
+namespace {
+    // Upper case only, lower case is mapped up and anything else draws as a space
+    constexpr const char glyphChars[] = " .:/%-()0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    constexpr int glyphCount = sizeof(glyphChars) - 1;
+
+    // One byte per row, bit 4 is the leftmost column
+    constexpr uint8_t glyphRows[glyphCount][7] = {
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // space
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, // .
+        { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 }, // :
+        { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 }, // /
+        { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 }, // %
+        { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 }, // -
+        { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 }, // (
+        { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 }, // )
+        { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, // 0
+        { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, // 1
+        { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, // 2
+        { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, // 3
+        { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, // 4
+        { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, // 5
+        { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, // 6
+        { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // 7
+        { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, // 8
+        { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, // 9
+        { 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 }, // A
+        { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E }, // B
+        { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, // C
+        { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C }, // D
+        { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, // E
+        { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, // F
+        { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, // G
+        { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // H
+        { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, // I
+        { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C }, // J
+        { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, // K
+        { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F }, // L
+        { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, // M
+        { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, // N
+        { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // O
+        { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, // P
+        { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, // Q
+        { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, // R
+        { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, // S
+        { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, // T
+        { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // U
+        { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, // V
+        { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A }, // W
+        { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, // X
+        { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 }, // Y
+        { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }, // Z
+    };
+
+    int glyphIndex(char c) {
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(c - 'a' + 'A');
+        }
+        const char* found = std::strchr(glyphChars, c);
+        return found == nullptr || c == '\0' ? 0 : static_cast<int>(found - glyphChars);
+    }
+
+    // The graph spans 0 to graphMaxMs, bars are colored against 60 and 30 fps
+    constexpr float graphMaxMs = 50.0f;
+    constexpr float goodMs = 1000.0f / 60.0f;
+    constexpr float slowMs = 1000.0f / 30.0f;
+    constexpr size_t graphFrames = 120;
+}
+
+void StatsOverlay::init(const ResourcesDB& configDB) {
+    State& s = state();
+    s.visible = configDB.mainDoc.getBool("stats_overlay", false);
+    s.scale = std::max(configDB.mainDoc.getInt("stats_overlay_scale", 2), 1);
+    s.frameMs.assign(historySize, 0.0f);
+    s.nextFrame = 0;
+
+    luabridge::getGlobalNamespace(ComponentManager::getLuaState())
+        .beginNamespace("Debug")
+        .addFunction("ShowStats", &StatsOverlay::setVisible)
+        .addFunction("IsShowingStats", &StatsOverlay::isVisible)
+        .endNamespace();
+}
+
+void StatsOverlay::destroy() {
+    State& s = state();
+    if (s.font != nullptr) {
+        SDL_DestroyTexture(s.font);
+        s.font = nullptr;
+    }
+}
+
+void StatsOverlay::setVisible(bool visible) {
+    state().visible = visible;
+}
+
+bool StatsOverlay::isVisible() {
+    return state().visible;
+}
+
+void StatsOverlay::toggle() {
+    State& s = state();
+    s.visible = !s.visible;
+}
+
+void StatsOverlay::addFrame(const FlightRecorder::Record& record) {
+    State& s = state();
+    if (s.frameMs.empty()) {
+        return;
+    }
+    s.frameMs[s.nextFrame % historySize] = record.frameMs;
+    s.nextFrame++;
+    s.latest = record;
+
+    if (s.visible) {
+        s.components = 0;
+        for (const auto& actor : ActorsGuild::getMembers()) {
+            s.components += static_cast<int>(actor->components.size());
+        }
+    }
+}
+
+void StatsOverlay::draw(SDL_Renderer* renderer, const CacheSizes& caches) {
+    State& s = state();
+    if (!s.visible || s.nextFrame == 0) {
+        return;
+    }
+    if (s.font == nullptr && !createFont(renderer)) {
+        return;
+    }
+
+    const size_t frames = std::min(s.nextFrame, historySize);
+    float totalMs = 0.0f;
+    for (size_t i = 0; i < frames; i++) {
+        totalMs += s.frameMs[i];
+    }
+    const float fps = totalMs > 0.0f ? 1000.0f * static_cast<float>(frames) / totalMs : 0.0f;
+
+    // Allocation lines only in builds that track them
+    const int lineCount = AllocationTracker::isEnabled() ? 11 : 9;
+    char lines[11][64];
+    std::snprintf(lines[0], sizeof(lines[0]), "FPS %.1f  FRAME %.2f MS", fps, s.latest.frameMs);
+    std::snprintf(lines[1], sizeof(lines[1]), "P50 %.1f P90 %.1f P99 %.1f MAX %.1f", percentileMs(50), percentileMs(90), percentileMs(99), percentileMs(100));
+    std::snprintf(lines[2], sizeof(lines[2]), "UPDATE %.2f RENDER %.2f PRESENT %.2f", s.latest.phaseMs[FlightRecorder::UPDATE], s.latest.phaseMs[FlightRecorder::RENDER], RenderStats::getPresentMs());
+    std::snprintf(lines[3], sizeof(lines[3]), "ACTORS %d COMPONENTS %d", s.latest.actors, s.components);
+    std::snprintf(lines[4], sizeof(lines[4]), "QUEUED IMAGES %d TEXT %d PIXELS %d", s.latest.queuedImages, s.latest.queuedText, s.latest.queuedPixels);
+    std::snprintf(lines[5], sizeof(lines[5]), "DRAW CALLS %d BATCHES %d CULLED %d", RenderStats::getDrawCalls(), RenderStats::getBatches(), RenderStats::getCulled());
+    std::snprintf(lines[6], sizeof(lines[6]), "SPRITES %d TEXTURES %d", caches.sprites, caches.textures);
+    std::snprintf(lines[7], sizeof(lines[7]), "TEXT CACHE %d GLYPH PAGES %d", caches.textTextures, caches.glyphPages);
+    std::snprintf(lines[8], sizeof(lines[8]), "LUA HEAP %d KB", s.latest.luaHeapKb);
+    if (AllocationTracker::isEnabled()) {
+        using AllocationTracker::Tag;
+        const AllocationTracker::Counts& allocations = AllocationTracker::getLastFrame();
+        const auto tagged = [&](Tag tag) { return static_cast<unsigned long long>(allocations.allocations[static_cast<size_t>(tag)]); };
+        std::snprintf(lines[9], sizeof(lines[9]), "ALLOCATIONS %llu (%llu KB)",
+            static_cast<unsigned long long>(allocations.totalAllocations()), static_cast<unsigned long long>(allocations.totalBytes() / 1024));
+        std::snprintf(lines[10], sizeof(lines[10]), "ACT %llu REN %llu IN %llu LUA %llu OTHER %llu",
+            tagged(Tag::Actors), tagged(Tag::Renderer), tagged(Tag::Input), tagged(Tag::Lua), tagged(Tag::Other));
+    }
+
+    size_t longest = 0;
+    for (int i = 0; i < lineCount; i++) {
+        longest = std::max(longest, std::strlen(lines[i]));
+    }
+    const int margin = 4 * s.scale;
+    const int lineHeight = cellHeight * s.scale;
+    const int graphWidth = static_cast<int>(graphFrames) * s.scale;
+    const int graphHeight = 40 * s.scale;
+    const int panelWidth = std::max(static_cast<int>(longest) * cellWidth * s.scale, graphWidth) + 2 * margin;
+    const int panelHeight = lineCount * lineHeight + graphHeight + margin + 2 * margin;
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 190);
+    const SDL_Rect panel = { margin, margin, panelWidth, panelHeight };
+    SDL_RenderFillRect(renderer, &panel);
+
+    // Frame times first, the graph sits right under them
+    int x = panel.x + margin;
+    int y = panel.y + margin;
+    drawText(renderer, x, y, lines[0]);
+    drawText(renderer, x, y + lineHeight, lines[1]);
+    y += 2 * lineHeight;
+    drawGraph(renderer, x, y, graphWidth, graphHeight);
+    y += graphHeight + margin;
+    for (int i = 2; i < lineCount; i++) {
+        drawText(renderer, x, y, lines[i]);
+        y += lineHeight;
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+bool StatsOverlay::createFont(SDL_Renderer* renderer) {
+    State& s = state();
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, glyphCount * glyphWidth, glyphHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (surface == nullptr) {
+        return false;
+    }
+    for (int glyph = 0; glyph < glyphCount; glyph++) {
+        for (int row = 0; row < glyphHeight; row++) {
+            auto* pixels = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(surface->pixels) + row * surface->pitch);
+            for (int column = 0; column < glyphWidth; column++) {
+                const bool set = (glyphRows[glyph][row] >> (glyphWidth - 1 - column)) & 1;
+                pixels[glyph * glyphWidth + column] = set ? 0xFFFFFFFFu : 0u;
+            }
+        }
+    }
+    s.font = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (s.font == nullptr) {
+        return false;
+    }
+    SDL_SetTextureBlendMode(s.font, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+float StatsOverlay::percentileMs(float percent) {
+    State& s = state();
+    const size_t frames = std::min(s.nextFrame, historySize);
+    std::vector<float> sorted(s.frameMs.begin(), s.frameMs.begin() + static_cast<std::ptrdiff_t>(frames));
+    // Nearest rank, same as the headless report
+    const size_t rank = static_cast<size_t>(std::clamp(std::ceil(percent / 100.0f * static_cast<float>(frames)), 1.0f, static_cast<float>(frames)));
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(rank - 1), sorted.end());
+    return sorted[rank - 1];
+}
+
+void StatsOverlay::drawText(SDL_Renderer* renderer, int x, int y, const char* text) {
+    State& s = state();
+    for (int i = 0; text[i] != '\0'; i++) {
+        const int glyph = glyphIndex(text[i]);
+        if (glyph == 0) {
+            continue;
+        }
+        const SDL_Rect source = { glyph * glyphWidth, 0, glyphWidth, glyphHeight };
+        const SDL_Rect destination = { x + i * cellWidth * s.scale, y, glyphWidth * s.scale, glyphHeight * s.scale };
+        SDL_RenderCopy(renderer, s.font, &source, &destination);
+    }
+}
+
+void StatsOverlay::drawGraph(SDL_Renderer* renderer, int x, int y, int width, int height) {
+    State& s = state();
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 40);
+    const SDL_Rect background = { x, y, width, height };
+    SDL_RenderFillRect(renderer, &background);
+
+    // Newest frame on the right, one bar per frame
+    std::vector<SDL_Rect> bars[3];
+    const size_t frames = std::min({ s.nextFrame, historySize, graphFrames });
+    for (size_t i = 0; i < frames; i++) {
+        const float ms = s.frameMs[(s.nextFrame - 1 - i) % historySize];
+        const int barHeight = std::max(1, static_cast<int>(std::min(ms, graphMaxMs) / graphMaxMs * static_cast<float>(height)));
+        const int barX = x + width - static_cast<int>(i + 1) * s.scale;
+        bars[ms <= goodMs ? 0 : ms <= slowMs ? 1 : 2].push_back({ barX, y + height - barHeight, s.scale, barHeight });
+    }
+    const SDL_Color colors[3] = { { 80, 220, 100, 255 }, { 240, 200, 60, 255 }, { 240, 70, 60, 255 } };
+    for (int i = 0; i < 3; i++) {
+        if (!bars[i].empty()) {
+            SDL_SetRenderDrawColor(renderer, colors[i].r, colors[i].g, colors[i].b, colors[i].a);
+            SDL_RenderFillRects(renderer, bars[i].data(), static_cast<int>(bars[i].size()));
+        }
+    }
+
+    // 60 and 30 fps reference lines
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 120);
+    for (const float ms : { goodMs, slowMs }) {
+        const int lineY = y + height - static_cast<int>(ms / graphMaxMs * static_cast<float>(height));
+        SDL_RenderDrawLine(renderer, x, lineY, x + width - 1, lineY);
+    }
+}
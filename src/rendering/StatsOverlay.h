@@ -0,0 +1,69 @@
+#ifndef STATSOVERLAY_H
+#define STATSOVERLAY_H
+
+#include <atomic>
+#include <vector>
+
+#include "SDL2/SDL.h"
+#include "../core/FlightRecorder.h"
+
+// Performance HUD drawn over everything else, toggled with F3 or Debug.ShowStats(true)
+// Text uses a built-in 5x7 bitmap font so it works without any font in resources/
+class StatsOverlay
+{
+public:
+    // Renderer state the overlay can't see from here
+    struct CacheSizes {
+        int sprites;
+        int textures;
+        int textTextures;
+        int glyphPages;
+    };
+
+    static void init(const ResourcesDB& configDB);
+    static void destroy();
+
+    static void setVisible(bool visible);
+    static bool isVisible();
+    static void toggle();
+
+    // Once per frame from the Engine while the simulation is idle
+    static void addFrame(const FlightRecorder::Record& record);
+
+    // Called by the Renderer after the UI pass, at render scale 1
+    static void draw(SDL_Renderer* renderer, const CacheSizes& caches);
+
+private:
+    static constexpr int glyphWidth = 5;
+    static constexpr int glyphHeight = 7;
+    // Glyph plus one pixel of spacing
+    static constexpr int cellWidth = glyphWidth + 1;
+    static constexpr int cellHeight = glyphHeight + 2;
+    static constexpr size_t historySize = 240;
+
+    friend class EngineContext;
+
+    struct State {
+        // Set from Lua on the simulation thread while pipelined
+        std::atomic<bool> visible = false;
+        int scale = 2;
+
+        SDL_Texture* font = nullptr;
+
+        // Frame times of the graph and percentiles, oldest first once full
+        std::vector<float> frameMs = {};
+        size_t nextFrame = 0;
+        FlightRecorder::Record latest = {};
+        // Counted only while visible, it walks every actor
+        int components = 0;
+    };
+
+    static State& state();
+
+    static bool createFont(SDL_Renderer* renderer);
+    static float percentileMs(float percent);
+    static void drawText(SDL_Renderer* renderer, int x, int y, const char* text);
+    static void drawGraph(SDL_Renderer* renderer, int x, int y, int width, int height);
+};
+
+#endif
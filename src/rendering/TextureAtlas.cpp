@@ -0,0 +1,205 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+
+std::unordered_map<std::string, Sprite> TextureAtlas::build(SDL_Renderer* renderer, std::vector<Image>& images, bool pack, int pageSize) {
+    State& s = state();
+    std::unordered_map<std::string, Sprite> sprites;
+    sprites.reserve(images.size());
+
+    SDL_RendererInfo info{};
+    if (SDL_GetRendererInfo(renderer, &info) == 0) {
+        // Software renderers report 0, meaning no limit
+        if (info.max_texture_width > 0) {
+            pageSize = std::min(pageSize, info.max_texture_width);
+        }
+        if (info.max_texture_height > 0) {
+            pageSize = std::min(pageSize, info.max_texture_height);
+        }
+    }
+
+    // Tallest first keeps shelves tight, name breaks ties so the layout is the same every run
+    std::vector<size_t> order;
+    for (size_t i = 0; i < images.size(); i++) {
+        const SDL_Surface* surface = images[i].surface;
+        if (!pack || surface == nullptr || !images[i].hasAlpha
+            || surface->w + padding * 2 > pageSize || surface->h + padding * 2 > pageSize) {
+            sprites[images[i].name] = makeStandalone(renderer, images[i]);
+            continue;
+        }
+        order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&images](size_t lhs, size_t rhs) {
+        if (images[lhs].surface->h != images[rhs].surface->h) {
+            return images[lhs].surface->h > images[rhs].surface->h;
+        }
+        return images[lhs].name < images[rhs].name;
+    });
+
+    // Shelf packing, the page height actually used is tracked so the last page can be trimmed
+    std::vector<Placement> placements;
+    std::vector<int> pageHeights;
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+    for (const size_t index : order) {
+        const int width = images[index].surface->w + padding * 2;
+        const int height = images[index].surface->h + padding * 2;
+
+        if (pageHeights.empty()) {
+            pageHeights.push_back(0);
+        }
+        if (shelfX + width > pageSize) {
+            shelfY += shelfHeight;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+        if (shelfY + height > pageSize) {
+            pageHeights.push_back(0);
+            shelfX = 0;
+            shelfY = 0;
+            shelfHeight = 0;
+        }
+
+        const int page = static_cast<int>(pageHeights.size()) - 1;
+        placements.push_back({ index, page, shelfX, shelfY });
+        shelfX += width;
+        shelfHeight = std::max(shelfHeight, height);
+        pageHeights[page] = std::max(pageHeights[page], shelfY + shelfHeight);
+    }
+
+    // Blit everything into the page surfaces, then upload each page once
+    std::vector<SDL_Surface*> pages;
+    for (const int height : pageHeights) {
+        SDL_Surface* page = SDL_CreateRGBSurfaceWithFormat(0, pageSize, height, 32, SDL_PIXELFORMAT_RGBA32);
+        SDL_FillRect(page, nullptr, 0);
+        pages.push_back(page);
+    }
+    for (const Placement& placement : placements) {
+        blitExtruded(pages[placement.page], images[placement.image].surface, placement.x, placement.y);
+    }
+
+    std::vector<SDL_Texture*> pageTextures;
+    std::vector<uint16_t> pageIds;
+    for (SDL_Surface* page : pages) {
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, page);
+        SDL_FreeSurface(page);
+        s.textures.push_back(texture);
+        pageTextures.push_back(texture);
+        pageIds.push_back(nextTextureId());
+    }
+    s.pageCount += static_cast<int>(pages.size());
+
+    for (const Placement& placement : placements) {
+        const SDL_Surface* surface = images[placement.image].surface;
+        const float pageWidth = static_cast<float>(pageSize);
+        const float pageHeight = static_cast<float>(pageHeights[placement.page]);
+
+        Sprite sprite;
+        sprite.texture = pageTextures[placement.page];
+        sprite.textureId = pageIds[placement.page];
+        sprite.source = { placement.x + padding, placement.y + padding, surface->w, surface->h };
+        sprite.uv = { sprite.source.x / pageWidth, sprite.source.y / pageHeight, sprite.source.w / pageWidth, sprite.source.h / pageHeight };
+        sprites[images[placement.image].name] = sprite;
+    }
+
+    for (Image& image : images) {
+        SDL_FreeSurface(image.surface);
+        image.surface = nullptr;
+    }
+    return sprites;
+}
+
+Sprite TextureAtlas::subSprite(const Sprite& parent, SDL_Rect rect) {
+    rect.x += parent.source.x;
+    rect.y += parent.source.y;
+    SDL_Rect clipped{};
+    if (!SDL_IntersectRect(&rect, &parent.source, &clipped)) {
+        clipped = { parent.source.x, parent.source.y, 0, 0 };
+    }
+
+    Sprite sprite;
+    sprite.texture = parent.texture;
+    sprite.textureId = parent.textureId;
+    sprite.source = clipped;
+
+    int textureWidth = 0;
+    int textureHeight = 0;
+    SDL_QueryTexture(parent.texture, nullptr, nullptr, &textureWidth, &textureHeight);
+    if (textureWidth > 0 && textureHeight > 0) {
+        const float width = static_cast<float>(textureWidth);
+        const float height = static_cast<float>(textureHeight);
+        sprite.uv = { clipped.x / width, clipped.y / height, clipped.w / width, clipped.h / height };
+    }
+    return sprite;
+}
+
+int TextureAtlas::getPageCount() {
+    return state().pageCount;
+}
+
+int TextureAtlas::getTextureCount() {
+    return static_cast<int>(state().textures.size());
+}
+
+size_t TextureAtlas::getTextureBytes() {
+    size_t bytes = 0;
+    for (SDL_Texture* texture : state().textures) {
+        int width = 0;
+        int height = 0;
+        SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+        bytes += static_cast<size_t>(width) * height * 4;
+    }
+    return bytes;
+}
+
+void TextureAtlas::destroy() {
+    State& s = state();
+    for (SDL_Texture* texture : s.textures) {
+        SDL_DestroyTexture(texture);
+    }
+    s.textures.clear();
+    s.pageCount = 0;
+}
+
+Sprite TextureAtlas::makeStandalone(SDL_Renderer* renderer, const Image& image) {
+    Sprite sprite;
+    if (image.surface == nullptr) {
+        return sprite;
+    }
+    sprite.texture = SDL_CreateTextureFromSurface(renderer, image.surface);
+    // RGBA32 surfaces always come out blended, opaque sources were never blended before
+    if (!image.hasAlpha) {
+        SDL_SetTextureBlendMode(sprite.texture, SDL_BLENDMODE_NONE);
+    }
+    sprite.source = { 0, 0, image.surface->w, image.surface->h };
+    state().textures.push_back(sprite.texture);
+    sprite.textureId = nextTextureId();
+    return sprite;
+}
+
+uint16_t TextureAtlas::nextTextureId() {
+    // Past the 16-bit range textures share the last id, they just stop being grouped
+    return static_cast<uint16_t>(std::min<size_t>(state().textures.size(), 0xffff));
+}
+
+void TextureAtlas::blitExtruded(SDL_Surface* page, SDL_Surface* image, int x, int y) {
+    // Straight copy, the page starts fully transparent and color keyed pixels stay that way
+    SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_NONE);
+    SDL_Rect dest = { x + padding, y + padding, image->w, image->h };
+    SDL_BlitSurface(image, nullptr, page, &dest);
+
+    // Repeat the outermost pixels into the padding
+    SDL_LockSurface(page);
+    auto* pixels = static_cast<uint8_t*>(page->pixels);
+    const auto pixelAt = [&](int px, int py) { return pixels + static_cast<size_t>(py) * page->pitch + static_cast<size_t>(px) * 4; };
+    for (int row = y + padding; row < y + padding + image->h; row++) {
+        std::memcpy(pixelAt(x, row), pixelAt(x + padding, row), 4);
+        std::memcpy(pixelAt(x + padding + image->w, row), pixelAt(x + image->w, row), 4);
+    }
+    const size_t rowBytes = static_cast<size_t>(image->w + padding * 2) * 4;
+    std::memcpy(pixelAt(x, y), pixelAt(x, y + padding), rowBytes);
+    std::memcpy(pixelAt(x, y + padding + image->h), pixelAt(x, y + image->h), rowBytes);
+    SDL_UnlockSurface(page);
+}
@@ -0,0 +1,63 @@
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SDL2/SDL.h"
+#include "Sprite.h"
+
+// Packs the loaded images into a few large textures (pages) so consecutive draws rarely switch texture
+// Pages are filled shelf by shelf, tallest images first. Every image gets a 1px border copied from its
+// own edge pixels so filtering and rotated draws never pick up a neighbour.
+class TextureAtlas
+{
+public:
+    struct Image {
+        std::string name;
+        SDL_Surface* surface = nullptr;
+        bool hasAlpha = true;
+    };
+
+    // Consumes the surfaces and returns a sprite per image name
+    // Opaque images and images that don't fit a page keep a texture of their own, as does everything when packing is off
+    static std::unordered_map<std::string, Sprite> build(SDL_Renderer* renderer, std::vector<Image>& images, bool pack, int pageSize);
+
+    // Sprite for a sub-rectangle of an existing sprite, clipped to it
+    static Sprite subSprite(const Sprite& parent, SDL_Rect rect);
+
+    static int getPageCount();
+    // Pages plus standalone textures
+    static int getTextureCount();
+    // Estimated from each texture's size at 4 bytes per pixel
+    static size_t getTextureBytes();
+
+    // Destroys every texture created by build
+    static void destroy();
+
+private:
+    static constexpr int padding = 1;
+
+    struct Placement {
+        size_t image;
+        int page;
+        int x;
+        int y;
+    };
+
+    friend class EngineContext;
+
+    struct State {
+        std::vector<SDL_Texture*> textures = {};
+        int pageCount = 0;
+    };
+
+    static State& state();
+
+    static uint16_t nextTextureId();
+    static Sprite makeStandalone(SDL_Renderer* renderer, const Image& image);
+    static void blitExtruded(SDL_Surface* page, SDL_Surface* image, int x, int y);
+};
+
+#endif
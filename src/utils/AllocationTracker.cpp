@@ -0,0 +1,369 @@
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+
+namespace {
+    constexpr const char* tagNames[AllocationTracker::tagCount] = { "other", "actors", "renderer", "input", "lua" };
+}
+
+const char* AllocationTracker::getTagName(Tag tag) {
+    return tagNames[static_cast<size_t>(tag)];
+}
+
+uint64_t AllocationTracker::Counts::totalAllocations() const {
+    uint64_t total = 0;
+    for (const uint64_t count : allocations) {
+        total += count;
+    }
+    return total;
+}
+
+uint64_t AllocationTracker::Counts::totalBytes() const {
+    uint64_t total = 0;
+    for (const uint64_t count : bytes) {
+        total += count;
+    }
+    return total;
+}
+
+AllocationTracker::Counts AllocationTracker::Counts::operator-(const Counts& other) const {
+    Counts difference{};
+    for (size_t i = 0; i < tagCount; i++) {
+        difference.allocations[i] = allocations[i] - other.allocations[i];
+        difference.bytes[i] = bytes[i] - other.bytes[i];
+    }
+    return difference;
+}
+
+#ifdef ENGINE_TRACK_ALLOCATIONS
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#define ALLOCATIONTRACKER_SITES 1
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+#if defined(__GNUC__)
+#define ALLOCATIONTRACKER_INLINE __attribute__((always_inline)) inline
+#else
+#define ALLOCATIONTRACKER_INLINE inline
+#endif
+
+thread_local AllocationTracker::Tag AllocationTracker::currentTag = AllocationTracker::Tag::Other;
+
+namespace {
+    std::atomic<uint64_t> allocations[AllocationTracker::tagCount] = {};
+    std::atomic<uint64_t> bytes[AllocationTracker::tagCount] = {};
+
+    AllocationTracker::Counts frameStart{};
+    AllocationTracker::Counts lastFrame{};
+
+    ALLOCATIONTRACKER_INLINE void count(AllocationTracker::Tag tag, std::size_t size) {
+        allocations[static_cast<size_t>(tag)].fetch_add(1, std::memory_order_relaxed);
+        bytes[static_cast<size_t>(tag)].fetch_add(size, std::memory_order_relaxed);
+    }
+
+#ifdef ALLOCATIONTRACKER_SITES
+    // Stacks are keyed as captured, reportTopSites merges them by their first frame outside the C++ runtime
+    constexpr int siteDepth = 6;
+    constexpr size_t siteSlots = 4096;
+
+    struct Site {
+        uint64_t hash;
+        void* frames[siteDepth];
+        int depth;
+        uint64_t allocations;
+        uint64_t bytes;
+    };
+
+    // Fixed storage, recording a site must never allocate
+    Site sites[siteSlots];
+    std::mutex sitesMutex;
+    uint64_t droppedSamples = 0;
+
+    uint32_t readSampleRate() {
+        const char* value = std::getenv("ALLOCATION_SITES");
+        if (value == nullptr) {
+            return 0;
+        }
+        // Loads the unwinder now rather than from inside the first sampled allocation
+        void* frames[1];
+        backtrace(frames, 1);
+        return static_cast<uint32_t>(std::max(std::atoi(value), 1));
+    }
+
+    // Allocations before this is initialized are simply not sampled
+    const uint32_t sampleEvery = readSampleRate();
+    thread_local uint32_t sampleCountdown = 0;
+    thread_local bool capturing = false;
+
+    __attribute__((noinline)) void storeSite(void* const* frames, int depth, std::size_t size) {
+        uint64_t hash = 1469598103934665603ull;
+        for (int i = 0; i < depth; i++) {
+            hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ull;
+        }
+        hash |= 1;
+
+        const std::lock_guard<std::mutex> lock(sitesMutex);
+        for (size_t probe = 0; probe < siteSlots; probe++) {
+            Site& site = sites[(hash + probe) % siteSlots];
+            if (site.hash == 0) {
+                site.hash = hash;
+                std::copy(frames, frames + depth, site.frames);
+                site.depth = depth;
+            }
+            if (site.hash == hash) {
+                site.allocations++;
+                site.bytes += size;
+                return;
+            }
+        }
+        droppedSamples++;
+    }
+
+    // Inlined into operator new so frame 0 is operator new itself and frame 1 its caller
+    ALLOCATIONTRACKER_INLINE void sampleSite(std::size_t size) {
+        if (sampleEvery == 0 || capturing || ++sampleCountdown < sampleEvery) {
+            return;
+        }
+        sampleCountdown = 0;
+        capturing = true;
+        void* frames[siteDepth + 1];
+        const int captured = backtrace(frames, siteDepth + 1);
+        capturing = false;
+        if (captured > 1) {
+            storeSite(frames + 1, captured - 1, size);
+        }
+    }
+
+    bool isRuntimeFrame(void* address) {
+        Dl_info info{};
+        if (dladdr(address, &info) == 0 || info.dli_fname == nullptr) {
+            return false;
+        }
+        const std::string module = info.dli_fname;
+        return module.find("libstdc++") != std::string::npos || module.find("libc++") != std::string::npos;
+    }
+
+    std::string describeFrame(void* address) {
+        char offset[32];
+        Dl_info info{};
+        if (dladdr(address, &info) != 0 && info.dli_sname != nullptr) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            std::string name = status == 0 && demangled != nullptr ? demangled : info.dli_sname;
+            std::free(demangled);
+            if (name.size() > 100) {
+                name = name.substr(0, 97) + "...";
+            }
+            std::snprintf(offset, sizeof(offset), "+0x%zx", static_cast<size_t>(static_cast<char*>(address) - static_cast<char*>(info.dli_saddr)));
+            return name + offset;
+        }
+        // Without -rdynamic there is no symbol, module offsets still resolve with addr2line
+        if (info.dli_fname != nullptr) {
+            std::string module = info.dli_fname;
+            module = module.substr(module.find_last_of('/') + 1);
+            std::snprintf(offset, sizeof(offset), "+0x%zx", static_cast<size_t>(static_cast<char*>(address) - static_cast<char*>(info.dli_fbase)));
+            return module + offset;
+        }
+        std::snprintf(offset, sizeof(offset), "%p", address);
+        return offset;
+    }
+#else
+    ALLOCATIONTRACKER_INLINE void sampleSite(std::size_t) {}
+#endif
+
+    ALLOCATIONTRACKER_INLINE void* allocate(std::size_t size) {
+        count(AllocationTracker::currentTag, size);
+        sampleSite(size);
+        if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+            return pointer;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+// The nothrow forms forward to these in libstdc++ and libc++, over-aligned allocations are not counted
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+bool AllocationTracker::isEnabled() {
+    return true;
+}
+
+uint64_t AllocationTracker::getAllocations() {
+    return getCounts().totalAllocations();
+}
+
+uint64_t AllocationTracker::getBytes() {
+    return getCounts().totalBytes();
+}
+
+AllocationTracker::Counts AllocationTracker::getCounts() {
+    Counts counts{};
+    for (size_t i = 0; i < tagCount; i++) {
+        counts.allocations[i] = allocations[i].load(std::memory_order_relaxed);
+        counts.bytes[i] = bytes[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+void AllocationTracker::endFrame() {
+    const Counts now = getCounts();
+    lastFrame = now - frameStart;
+    frameStart = now;
+}
+
+const AllocationTracker::Counts& AllocationTracker::getLastFrame() {
+    return lastFrame;
+}
+
+void* AllocationTracker::luaAlloc(void*, void* pointer, size_t oldSize, size_t newSize) {
+    if (newSize == 0) {
+        std::free(pointer);
+        return nullptr;
+    }
+    // oldSize is a type tag when pointer is null, any new block or growth counts
+    if (pointer == nullptr || newSize > oldSize) {
+        count(Tag::Lua, newSize);
+    }
+    return std::realloc(pointer, newSize);
+}
+
+#ifdef ALLOCATIONTRACKER_SITES
+
+bool AllocationTracker::isSamplingSites() {
+    return sampleEvery != 0;
+}
+
+void AllocationTracker::reportTopSites(std::ostream& os, size_t count) {
+    if (sampleEvery == 0) {
+        return;
+    }
+    struct Merged {
+        void* frame;
+        void* caller;
+        uint64_t allocations;
+        uint64_t bytes;
+    };
+    std::vector<Merged> merged;
+    {
+        // The report allocates while holding the lock, sampling this thread would deadlock
+        capturing = true;
+        std::unordered_map<void*, size_t> byFrame;
+        const std::lock_guard<std::mutex> lock(sitesMutex);
+        for (const Site& site : sites) {
+            if (site.hash == 0) {
+                continue;
+            }
+            int first = 0;
+            while (first + 1 < site.depth && isRuntimeFrame(site.frames[first])) {
+                first++;
+            }
+            void* caller = first + 1 < site.depth ? site.frames[first + 1] : nullptr;
+            const auto [it, inserted] = byFrame.try_emplace(site.frames[first], merged.size());
+            if (inserted) {
+                merged.push_back({ site.frames[first], caller, 0, 0 });
+            }
+            merged[it->second].allocations += site.allocations;
+            merged[it->second].bytes += site.bytes;
+        }
+        capturing = false;
+    }
+    std::sort(merged.begin(), merged.end(), [](const Merged& a, const Merged& b) { return a.allocations > b.allocations; });
+
+    os << "allocation sites sampled: 1 in " << sampleEvery << '\n';
+    for (size_t i = 0; i < std::min(count, merged.size()); i++) {
+        os << "allocation site " << i + 1 << ": " << merged[i].allocations * sampleEvery << " allocations "
+            << merged[i].bytes * sampleEvery / 1024 << " kb in " << describeFrame(merged[i].frame);
+        if (merged[i].caller != nullptr) {
+            os << " <- " << describeFrame(merged[i].caller);
+        }
+        os << '\n';
+    }
+    if (droppedSamples > 0) {
+        os << "allocation samples dropped: " << droppedSamples << '\n';
+    }
+}
+
+#else
+
+bool AllocationTracker::isSamplingSites() {
+    return false;
+}
+
+void AllocationTracker::reportTopSites(std::ostream&, size_t) {}
+
+#endif
+
+#else
+
+bool AllocationTracker::isEnabled() {
+    return false;
+}
+
+uint64_t AllocationTracker::getAllocations() {
+    return 0;
+}
+
+uint64_t AllocationTracker::getBytes() {
+    return 0;
+}
+
+AllocationTracker::Counts AllocationTracker::getCounts() {
+    return Counts{};
+}
+
+void AllocationTracker::endFrame() {}
+
+const AllocationTracker::Counts& AllocationTracker::getLastFrame() {
+    static const Counts none{};
+    return none;
+}
+
+void* AllocationTracker::luaAlloc(void*, void* pointer, size_t, size_t newSize) {
+    if (newSize == 0) {
+        std::free(pointer);
+        return nullptr;
+    }
+    return std::realloc(pointer, newSize);
+}
+
+bool AllocationTracker::isSamplingSites() {
+    return false;
+}
+
+void AllocationTracker::reportTopSites(std::ostream&, size_t) {}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Counts heap allocations made through operator new and the Lua allocator when built with
+// -DENGINE_TRACK_ALLOCATIONS (make bench does), otherwise every getter returns 0 and operator new is left alone
+// Allocations are attributed to the subsystem tag of the innermost ALLOCATION_SCOPE on the allocating thread,
+// Lua's own allocations always count as Lua
+namespace AllocationTracker {
+    enum class Tag : uint8_t { Other, Actors, Renderer, Input, Lua, Count };
+    constexpr size_t tagCount = static_cast<size_t>(Tag::Count);
+
+    // Lower case, as printed in reports
+    const char* getTagName(Tag tag);
+
+    struct Counts {
+        uint64_t allocations[tagCount];
+        uint64_t bytes[tagCount];
+
+        uint64_t totalAllocations() const;
+        uint64_t totalBytes() const;
+        Counts operator-(const Counts& other) const;
+    };
+
+    bool isEnabled();
+    // Totals since startup
+    uint64_t getAllocations();
+    uint64_t getBytes();
+    Counts getCounts();
+
+    // Closes the current frame, call once per frame on the main thread
+    void endFrame();
+    // Counts of the frame closed by the last endFrame
+    const Counts& getLastFrame();
+
+    // lua_Alloc counting under Tag::Lua, set on the Lua state when tracking is enabled
+    void* luaAlloc(void* userData, void* pointer, size_t oldSize, size_t newSize);
+
+    // Call sites are sampled, one allocation in ALLOCATION_SITES (environment) records its stack
+    bool isSamplingSites();
+    // The sites with the most sampled allocations, nothing when not sampling
+    void reportTopSites(std::ostream& os, size_t count);
+
+#ifdef ENGINE_TRACK_ALLOCATIONS
+    extern thread_local Tag currentTag;
+
+    class Scope
+    {
+    public:
+        explicit Scope(Tag tag) : previous(currentTag) { currentTag = tag; }
+        ~Scope() { currentTag = previous; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Tag previous;
+    };
+#endif
+}
+
+#ifdef ENGINE_TRACK_ALLOCATIONS
+#define ALLOCATION_CONCAT_INNER(a, b) a##b
+#define ALLOCATION_CONCAT(a, b) ALLOCATION_CONCAT_INNER(a, b)
+// ALLOCATION_SCOPE(Renderer) tags the enclosing scope's allocations
+#define ALLOCATION_SCOPE(tag) const AllocationTracker::Scope ALLOCATION_CONCAT(allocationScope, __LINE__)(AllocationTracker::Tag::tag)
+#else
+#define ALLOCATION_SCOPE(tag) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,87 @@
+#include "FrameDelta.h"
+
+#include <algorithm>
+
+namespace {
+    constexpr size_t minRun = 3;
+    constexpr size_t maxRun = 0x7f + minRun;
+    constexpr size_t maxLiteral = 0x80;
+
+    inline uint8_t deltaAt(const uint8_t* current, const uint8_t* previous, size_t i) {
+        return previous != nullptr ? current[i] ^ previous[i] : current[i];
+    }
+}
+
+void FrameDelta::encode(const uint8_t* current, const uint8_t* previous, size_t size, std::vector<uint8_t>& out) {
+    size_t literalStart = 0;
+    size_t i = 0;
+
+    const auto flushLiterals = [&](size_t end) {
+        while (literalStart < end) {
+            const size_t count = std::min(end - literalStart, maxLiteral);
+            out.push_back(static_cast<uint8_t>(count - 1));
+            for (size_t j = 0; j < count; j++) {
+                out.push_back(deltaAt(current, previous, literalStart + j));
+            }
+            literalStart += count;
+        }
+    };
+
+    while (i < size) {
+        const uint8_t value = deltaAt(current, previous, i);
+        size_t run = 1;
+        while (i + run < size && run < maxRun && deltaAt(current, previous, i + run) == value) {
+            run++;
+        }
+        if (run >= minRun) {
+            flushLiterals(i);
+            out.push_back(static_cast<uint8_t>(0x80 + run - minRun));
+            out.push_back(value);
+            i += run;
+            literalStart = i;
+        }
+        else {
+            i += run;
+        }
+    }
+    flushLiterals(size);
+}
+
+bool FrameDelta::decode(const uint8_t* data, size_t dataSize, const uint8_t* previous, uint8_t* frame, size_t size) {
+    size_t position = 0;
+    size_t written = 0;
+    while (written < size) {
+        if (position >= dataSize) {
+            return false;
+        }
+        const uint8_t control = data[position++];
+        if (control < 0x80) {
+            const size_t count = static_cast<size_t>(control) + 1;
+            if (position + count > dataSize || written + count > size) {
+                return false;
+            }
+            for (size_t j = 0; j < count; j++) {
+                frame[written + j] = data[position + j];
+            }
+            position += count;
+            written += count;
+        }
+        else {
+            const size_t count = static_cast<size_t>(control - 0x80) + minRun;
+            if (position >= dataSize || written + count > size) {
+                return false;
+            }
+            const uint8_t value = data[position++];
+            for (size_t j = 0; j < count; j++) {
+                frame[written + j] = value;
+            }
+            written += count;
+        }
+    }
+    if (previous != nullptr) {
+        for (size_t i = 0; i < size; i++) {
+            frame[i] ^= previous[i];
+        }
+    }
+    return position == dataSize;
+}
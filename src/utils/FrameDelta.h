@@ -0,0 +1,23 @@
+#ifndef FRAMEDELTA_H
+#define FRAMEDELTA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Run-length coding of a frame XORed with the previous one, what FrameCapture writes in delta mode
+// Consecutive frames mostly differ in a few sprites, so the XOR is long runs of zeros that collapse to a few bytes
+//
+// Stream: a control byte c followed by
+//   c < 0x80   c + 1 literal bytes
+//   c >= 0x80  one byte repeated c - 0x80 + minRun times
+namespace FrameDelta {
+    // previous may be nullptr for a keyframe, both buffers are size bytes, the stream is appended to out
+    void encode(const uint8_t* current, const uint8_t* previous, size_t size, std::vector<uint8_t>& out);
+
+    // Rebuilds size bytes into frame, previous (nullptr for a keyframe) is what encode was given
+    // Returns false on a truncated or malformed stream
+    bool decode(const uint8_t* data, size_t dataSize, const uint8_t* previous, uint8_t* frame, size_t size);
+}
+
+#endif
@@ -0,0 +1,80 @@
+#include "FrameHash.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRAMEHASH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr uint64_t key0 = 0x9e3779b97f4a7c15ull;
+    constexpr uint64_t key1 = 0xc2b2ae3d27d4eb4full;
+    constexpr uint64_t keyStep0 = 0x165667b19e3779f9ull;
+    constexpr uint64_t keyStep1 = 0x27d4eb2f165667c5ull;
+
+    inline uint64_t accumulate(uint64_t acc, uint64_t data, uint64_t key) {
+        const uint64_t v = data ^ key;
+        return acc + (v & 0xffffffffull) * (v >> 32) + data;
+    }
+
+    // murmur3 fmix64
+    inline uint64_t avalanche(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    inline uint64_t finish(uint64_t acc0, uint64_t acc1, const uint8_t* tail, size_t tailSize, uint64_t key, size_t size) {
+        // The last partial block is zero padded and goes through the same accumulate
+        uint8_t block[16] = {};
+        std::memcpy(block, tail, tailSize);
+        uint64_t low = 0;
+        uint64_t high = 0;
+        std::memcpy(&low, block, 8);
+        std::memcpy(&high, block + 8, 8);
+        acc0 = accumulate(acc0, low, key0 + key * keyStep0);
+        acc1 = accumulate(acc1, high, key1 + key * keyStep1);
+        return avalanche(acc0 ^ avalanche(acc1 + static_cast<uint64_t>(size)));
+    }
+}
+
+uint64_t FrameHash::hashScalar(const uint8_t* data, size_t size) {
+    const size_t blocks = size / 16;
+    uint64_t acc0 = 0;
+    uint64_t acc1 = 0;
+    for (size_t i = 0; i < blocks; i++) {
+        uint64_t low = 0;
+        uint64_t high = 0;
+        std::memcpy(&low, data + i * 16, 8);
+        std::memcpy(&high, data + i * 16 + 8, 8);
+        acc0 = accumulate(acc0, low, key0 + i * keyStep0);
+        acc1 = accumulate(acc1, high, key1 + i * keyStep1);
+    }
+    return finish(acc0, acc1, data + blocks * 16, size - blocks * 16, blocks, size);
+}
+
+uint64_t FrameHash::hash(const uint8_t* data, size_t size) {
+#ifdef FRAMEHASH_SSE2
+    const size_t blocks = size / 16;
+    __m128i acc = _mm_setzero_si128();
+    __m128i key = _mm_set_epi64x(static_cast<long long>(key1), static_cast<long long>(key0));
+    const __m128i step = _mm_set_epi64x(static_cast<long long>(keyStep1), static_cast<long long>(keyStep0));
+    for (size_t i = 0; i < blocks; i++) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16));
+        const __m128i v = _mm_xor_si128(block, key);
+        // Multiplies the low 32 bits of each 64-bit lane, lo32(v) * hi32(v)
+        const __m128i product = _mm_mul_epu32(v, _mm_srli_epi64(v, 32));
+        acc = _mm_add_epi64(acc, _mm_add_epi64(product, block));
+        key = _mm_add_epi64(key, step);
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return finish(lanes[0], lanes[1], data + blocks * 16, size - blocks * 16, blocks, size);
+#else
+    return hashScalar(data, size);
+#endif
+}
@@ -0,0 +1,16 @@
+#ifndef FRAMEHASH_H
+#define FRAMEHASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Fast 64-bit hash of a frame's pixels for checksum runs, not for anything adversarial
+// Two 64-bit lanes per 16-byte block accumulate lo32(v) * hi32(v) + data, v = data ^ key, with a key
+// that changes per block so moved blocks still change the hash. The SSE2 and scalar paths give the same result.
+namespace FrameHash {
+    uint64_t hash(const uint8_t* data, size_t size);
+    // Portable path, exposed so the SSE2 one can be checked against it
+    uint64_t hashScalar(const uint8_t* data, size_t size);
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef FRAMETIMESTATS_H
+#define FRAMETIMESTATS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+// Frame times of a run for throughput reports: fps and nearest-rank percentiles
+class FrameTimeStats
+{
+public:
+    // Without keepFrames only the count, total and last frame are tracked, percentiles read 0
+    // Every frame time is kept otherwise, which grows without bound over a long session
+    void start(bool keepFrames = true) {
+        frameStart = std::chrono::steady_clock::now();
+        keep = keepFrames;
+        frameMs.clear();
+        frameCount = 0;
+        lastMs = 0.0f;
+        totalSeconds = 0.0;
+    }
+
+    // Ends the current frame and starts the next one
+    void lap() {
+        const auto now = std::chrono::steady_clock::now();
+        const std::chrono::duration<double> elapsed = now - frameStart;
+        lastMs = static_cast<float>(elapsed.count() * 1000.0);
+        if (keep) {
+            frameMs.push_back(lastMs);
+        }
+        frameCount++;
+        totalSeconds += elapsed.count();
+        frameStart = now;
+    }
+
+    [[nodiscard]] float getLastMs() const { return lastMs; }
+    [[nodiscard]] size_t getFrameCount() const { return frameCount; }
+    [[nodiscard]] double getTotalSeconds() const { return totalSeconds; }
+    [[nodiscard]] double getFps() const { return totalSeconds > 0.0 ? frameCount / totalSeconds : 0.0; }
+
+    // percent in [0, 100]
+    [[nodiscard]] double percentileMs(double percent) const {
+        if (frameMs.empty()) {
+            return 0.0;
+        }
+        sorted = frameMs;
+        const size_t rank = static_cast<size_t>(std::clamp(std::ceil(percent / 100.0 * sorted.size()), 1.0, static_cast<double>(sorted.size())));
+        std::nth_element(sorted.begin(), sorted.begin() + (rank - 1), sorted.end());
+        return sorted[rank - 1];
+    }
+
+    [[nodiscard]] double maxMs() const {
+        return frameMs.empty() ? 0.0 : *std::max_element(frameMs.begin(), frameMs.end());
+    }
+
+    void report(std::ostream& os) const {
+        os << std::fixed << std::setprecision(3)
+            << "frames: " << getFrameCount() << '\n'
+            << "seconds: " << getTotalSeconds() << '\n'
+            << "fps: " << getFps() << '\n'
+            << "frame ms: p50 " << percentileMs(50) << " p90 " << percentileMs(90)
+            << " p99 " << percentileMs(99) << " max " << maxMs() << '\n';
+        os.unsetf(std::ios_base::floatfield);
+        os << std::setprecision(6);
+    }
+
+private:
+    std::chrono::steady_clock::time_point frameStart;
+    double totalSeconds = 0.0;
+    bool keep = true;
+    size_t frameCount = 0;
+    float lastMs = 0.0f;
+    std::vector<float> frameMs;
+    mutable std::vector<float> sorted;
+};
+
+#endif
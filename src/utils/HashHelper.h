@@ -1,6 +1,8 @@
 #ifndef HASHHELPER_H
 #define HASHHELPER_H
 #include <glm/vec2.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 template <>
@@ -26,4 +28,15 @@ struct std::hash<glm::vec2> {
             ^ (hash<float>()(k.y) << 1)) >> 1);
     }
 };
+
+// 64-bit FNV-1a, stable across runs and platforms (std::hash is not), used for on-disk cache keys
+inline uint64_t fnv1a64(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
 #endif
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "../../external_helpers/Helper.h"
+
+namespace {
+    constexpr auto limitWindow = std::chrono::seconds(1);
+    // Distinct messages tracked per window, anything past it is never counted as a repeat
+    constexpr size_t maxTrackedRepeats = 4096;
+    constexpr size_t previewLength = 80;
+}
+
+void Logger::start() {
+    if (running.exchange(true)) {
+        return;
+    }
+    limiting = !Helper::IsAutograderMode();
+    writer = std::thread(&Logger::writerLoop);
+    std::atexit(&Logger::stop);
+}
+
+void Logger::stop() {
+    if (running.exchange(false)) {
+        wake.notify_one();
+        // exit() from the writer itself can't happen, it never logs
+        if (writer.joinable()) {
+            writer.join();
+        }
+    }
+    flush();
+}
+
+void Logger::configure(Level minimumLevel, int repeatLimit, int rateLimit) {
+    Logger::minimumLevel.store(minimumLevel, std::memory_order_relaxed);
+    const std::lock_guard<std::mutex> lock(consumerMutex);
+    Logger::repeatLimit = std::max(repeatLimit, 0);
+    Logger::rateLimit = std::max(rateLimit, 0);
+}
+
+Logger::Level Logger::parseLevel(const std::string& name, Level fallback) {
+    if (name == "debug") {
+        return Debug;
+    }
+    if (name == "info") {
+        return Info;
+    }
+    if (name == "warning") {
+        return Warning;
+    }
+    if (name == "error") {
+        return Error;
+    }
+    return fallback;
+}
+
+const char* Logger::getCategoryName(Category category) {
+    static constexpr const char* names[CategoryCount] = { "engine", "lua", "input", "render", "assets", "audio" };
+    return category < CategoryCount ? names[category] : "unknown";
+}
+
+void Logger::flush() {
+    const std::lock_guard<std::mutex> lock(consumerMutex);
+    while (drainLocked()) {
+    }
+    flushStreamsLocked();
+}
+
+std::string& Logger::scratch() {
+    thread_local std::string text;
+    return text;
+}
+
+void Logger::push(Level level, Category category, Stream stream, std::string_view text) {
+    // Too long for a slot, write it in place behind everything already queued
+    if (text.size() > textCapacity) {
+        const std::lock_guard<std::mutex> lock(consumerMutex);
+        while (drainLocked()) {
+        }
+        emitLocked(category, stream, text);
+        if (!running.load(std::memory_order_acquire)) {
+            flushStreamsLocked();
+        }
+        return;
+    }
+
+    while (!tryPush(level, category, stream, text)) {
+        // Full, wait for the writer rather than lose a line
+        if (running.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        else {
+            flush();
+        }
+    }
+
+    if (!running.load(std::memory_order_acquire)) {
+        flush();
+    }
+    else if (writerWaiting.load(std::memory_order_acquire)) {
+        wake.notify_one();
+    }
+}
+
+void Logger::fatalExit(std::string_view text) {
+    if (fatalHandler != nullptr) {
+        fatalHandler();
+    }
+    {
+        const std::lock_guard<std::mutex> lock(consumerMutex);
+        while (drainLocked()) {
+        }
+        std::cout << text;
+        flushStreamsLocked();
+        std::cout.flush();
+    }
+    exit(0);
+}
+
+bool Logger::tryPush(Level level, Category category, Stream stream, std::string_view text) {
+    size_t position = enqueuePosition.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true) {
+        slot = &ring[position & ringMask];
+        const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position & ~ringMask);
+        if (difference == 0) {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (difference < 0) {
+            return false;
+        }
+        else {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    slot->category = category;
+    slot->stream = stream;
+    slot->length = static_cast<uint16_t>(text.size());
+    std::memcpy(slot->text, text.data(), text.size());
+    slot->sequence.store((position & ~ringMask) + 1, std::memory_order_release);
+    return true;
+}
+
+bool Logger::drainLocked() {
+    bool wrote = false;
+    while (true) {
+        Slot& slot = ring[dequeuePosition & ringMask];
+        const size_t lap = dequeuePosition & ~ringMask;
+        if (slot.sequence.load(std::memory_order_acquire) != lap + 1) {
+            break;
+        }
+        emitLocked(slot.category, slot.stream, std::string_view(slot.text, slot.length));
+        // Free for the producer one lap ahead
+        slot.sequence.store(lap + ringCapacity, std::memory_order_release);
+        dequeuePosition++;
+        wrote = true;
+    }
+    return wrote;
+}
+
+void Logger::emitLocked(Category category, Stream stream, std::string_view text) {
+    // Only diagnostics are limited, stdout is program output: Debug.Log, reports
+    if (limiting && stream == Stream::Stderr) {
+        rollWindowLocked(std::chrono::steady_clock::now());
+
+        if (repeatLimit > 0) {
+            const uint64_t key = std::hash<std::string_view>()(text) * 31 + static_cast<uint64_t>(stream) * 8 + category;
+            auto it = repeats.find(key);
+            if (it == repeats.end() && repeats.size() < maxTrackedRepeats) {
+                it = repeats.emplace(key, Repeat{ std::string(text.substr(0, std::min(text.find('\n'), previewLength))) }).first;
+            }
+            if (it != repeats.end() && it->second.written++ >= repeatLimit) {
+                it->second.suppressed++;
+                return;
+            }
+        }
+        if (rateLimit > 0 && category < CategoryCount && categoryLines[category]++ >= rateLimit) {
+            categoryDropped[category]++;
+            return;
+        }
+    }
+
+    std::ostream& out = stream == Stream::Stdout ? std::cout : std::cerr;
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    unflushed[static_cast<size_t>(stream)] = true;
+}
+
+void Logger::rollWindowLocked(std::chrono::steady_clock::time_point now) {
+    if (now - windowStart < limitWindow) {
+        return;
+    }
+    windowStart = now;
+
+    for (const auto& [key, repeat] : repeats) {
+        if (repeat.suppressed > 0) {
+            std::cerr << "log: \"" << repeat.preview << "\" repeated " << repeat.suppressed << " more times\n";
+            unflushed[static_cast<size_t>(Stream::Stderr)] = true;
+        }
+    }
+    repeats.clear();
+
+    for (size_t i = 0; i < CategoryCount; i++) {
+        if (categoryDropped[i] > 0) {
+            std::cerr << "log: dropped " << categoryDropped[i] << ' ' << getCategoryName(static_cast<Category>(i)) << " messages\n";
+            unflushed[static_cast<size_t>(Stream::Stderr)] = true;
+        }
+        categoryLines[i] = 0;
+        categoryDropped[i] = 0;
+    }
+}
+
+void Logger::flushStreamsLocked() {
+    if (unflushed[static_cast<size_t>(Stream::Stdout)]) {
+        std::cout.flush();
+    }
+    if (unflushed[static_cast<size_t>(Stream::Stderr)]) {
+        std::cerr.flush();
+    }
+    unflushed[0] = unflushed[1] = false;
+}
+
+void Logger::writerLoop() {
+    while (running.load(std::memory_order_acquire)) {
+        {
+            const std::lock_guard<std::mutex> lock(consumerMutex);
+            if (drainLocked()) {
+                continue;
+            }
+            // Idle: report what the last window dropped even if nothing else gets logged
+            if (limiting) {
+                rollWindowLocked(std::chrono::steady_clock::now());
+            }
+            flushStreamsLocked();
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerWaiting.store(true, std::memory_order_release);
+        // Bounded wait, a producer that saw writerWaiting as false just before it was set is picked up here
+        wake.wait_for(lock, std::chrono::milliseconds(10));
+        writerWaiting.store(false, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// Memory mapping of a whole file, unmapped on destruction
+// Read-only mappings are shared too, so they see writes another process makes through a read-write one
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool openReadOnly(const std::filesystem::path& path);
+    // Creates the file if needed and sizes it to exactly size bytes
+    bool openReadWrite(const std::filesystem::path& path, size_t size);
+    void close();
+
+    bool isOpen() const { return mapped != nullptr; }
+    const uint8_t* data() const { return mapped; }
+    // nullptr unless opened with openReadWrite
+    uint8_t* writableData() { return writable ? mapped : nullptr; }
+    size_t size() const { return length; }
+
+private:
+    uint8_t* mapped = nullptr;
+    size_t length = 0;
+    bool writable = false;
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "Profiler.h"
+
+#ifdef ENGINE_PROFILER
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include "Logger.h"
+
+namespace {
+    const auto profilerEpoch = std::chrono::steady_clock::now();
+}
+
+uint64_t Profiler::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profilerEpoch).count());
+}
+
+Profiler::Zone::Zone(const char* name) : name(name), startNs(nowNs()) {
+    threadBuffer().depth++;
+}
+
+Profiler::Zone::~Zone() {
+    const uint64_t endNs = nowNs();
+    ThreadBuffer& buffer = threadBuffer();
+    buffer.depth--;
+    buffer.events[buffer.next] = { name, startNs, endNs - startNs, currentFrame.load(std::memory_order_relaxed), buffer.depth };
+    buffer.next = buffer.next + 1 == buffer.events.size() ? 0 : buffer.next + 1;
+    buffer.count = std::min(buffer.count + 1, buffer.events.size());
+}
+
+void Profiler::init(size_t eventsPerThread, const std::string& tracePath) {
+    Profiler::eventsPerThread = std::max<size_t>(eventsPerThread, 1);
+    Profiler::tracePath = tracePath;
+    std::atexit(&Profiler::exportAtExit);
+}
+
+void Profiler::markFrame(int frameNumber) {
+    currentFrame.store(frameNumber, std::memory_order_relaxed);
+}
+
+void Profiler::setThreadName(const char* name) {
+    threadBuffer().threadName = name;
+}
+
+Profiler::ThreadBuffer& Profiler::threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        const std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = buffers.back().get();
+        buffer->events.resize(eventsPerThread);
+        buffer->threadId = static_cast<uint32_t>(buffers.size());
+        buffer->threadName = buffers.size() == 1 ? "main" : "thread " + std::to_string(buffers.size());
+    }
+    return *buffer;
+}
+
+bool Profiler::exportChromeTrace(const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    const std::lock_guard<std::mutex> lock(buffersMutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    const auto separator = [&]() -> std::ofstream& {
+        out << (first ? "" : ",\n");
+        first = false;
+        return out;
+    };
+    out << std::fixed << std::setprecision(3);
+    for (const auto& buffer : buffers) {
+        separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+            << ",\"args\":{\"name\":\"" << buffer->threadName << "\"}}";
+        // Oldest first, ts and dur are in microseconds
+        const size_t oldest = (buffer->next + buffer->events.size() - buffer->count) % buffer->events.size();
+        for (size_t i = 0; i < buffer->count; i++) {
+            const Event& event = buffer->events[(oldest + i) % buffer->events.size()];
+            separator() << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << event.startNs / 1000.0 << ",\"dur\":" << event.durationNs / 1000.0
+                << ",\"args\":{\"frame\":" << event.frame << ",\"depth\":" << event.depth << "}}";
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+void Profiler::exportAtExit() {
+    if (!exportChromeTrace(tracePath)) {
+        Logger::error(Logger::Engine, "failed to write ", tracePath);
+    }
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scoped profiling zones, compiled in only with -DENGINE_PROFILER (make profile)
+//   PROFILE_ZONE("Renderer::sort");   times the enclosing scope
+//   PROFILE_FRAME(frameNumber);       marks the start of a frame
+//   PROFILE_THREAD("simulation");     names the calling thread in the trace
+// Every thread records into its own fixed ring of the most recent zones, nested zones keep their depth.
+// The rings are written out as Chrome trace-event JSON at exit, open it in chrome://tracing or Perfetto.
+// Without ENGINE_PROFILER the macros expand to nothing.
+#ifdef ENGINE_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) const Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FRAME(frameNumber) Profiler::markFrame(frameNumber)
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FRAME(frameNumber) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
+
+class Profiler
+{
+public:
+    struct Event {
+        // Zone names are string literals, never copied
+        const char* name;
+        uint64_t startNs;
+        uint64_t durationNs;
+        int32_t frame;
+        uint32_t depth;
+    };
+
+    class Zone
+    {
+    public:
+        explicit Zone(const char* name);
+        ~Zone();
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* name;
+        uint64_t startNs;
+    };
+
+    // Sets the ring size and the trace path, and exports the trace at exit
+    static void init(size_t eventsPerThread, const std::string& tracePath);
+
+    static void markFrame(int frameNumber);
+    static void setThreadName(const char* name);
+
+    // Profiled threads must be idle while this runs
+    static bool exportChromeTrace(const std::string& path);
+
+    static uint64_t nowNs();
+
+private:
+    struct ThreadBuffer {
+        std::vector<Event> events;
+        size_t next = 0;
+        size_t count = 0;
+        uint32_t depth = 0;
+        uint32_t threadId = 0;
+        std::string threadName;
+    };
+
+    // Owned here rather than by the threads so a finished thread's zones still get exported
+    static inline std::mutex buffersMutex;
+    static inline std::vector<std::unique_ptr<ThreadBuffer>> buffers = {};
+    static inline size_t eventsPerThread = size_t(1) << 16;
+    static inline std::string tracePath = "profile_trace.json";
+    static inline std::atomic<int> currentFrame = 0;
+
+    static ThreadBuffer& threadBuffer();
+    static void exportAtExit();
+};
+
+#endif
@@ -0,0 +1,193 @@
+#include "QoiCodec.h"
+
+#include <cstring>
+
+namespace {
+    constexpr uint8_t opIndex = 0x00;
+    constexpr uint8_t opDiff = 0x40;
+    constexpr uint8_t opLuma = 0x80;
+    constexpr uint8_t opRun = 0xc0;
+    constexpr uint8_t opRgb = 0xfe;
+    constexpr uint8_t opRgba = 0xff;
+    constexpr uint8_t tagMask = 0xc0;
+
+    constexpr size_t headerSize = 14;
+    constexpr uint8_t endMarker[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    // Keeps a corrupt header from asking for gigabytes
+    constexpr uint64_t maxPixels = 400000000;
+
+    struct Pixel {
+        uint8_t r, g, b, a;
+    };
+
+    inline bool operator==(const Pixel& lhs, const Pixel& rhs) {
+        return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b && lhs.a == rhs.a;
+    }
+
+    inline uint32_t indexOf(const Pixel& px) {
+        return (px.r * 3u + px.g * 5u + px.b * 7u + px.a * 11u) % 64u;
+    }
+
+    inline void write32(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    inline uint32_t read32(const uint8_t* data) {
+        return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16)
+            | (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+    }
+}
+
+void QoiCodec::encode(const uint8_t* rgba, uint32_t width, uint32_t height, std::vector<uint8_t>& out) {
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    // Worst case is one RGBA chunk per pixel
+    out.reserve(out.size() + headerSize + pixelCount * 5 + sizeof(endMarker));
+
+    out.insert(out.end(), { 'q', 'o', 'i', 'f' });
+    write32(out, width);
+    write32(out, height);
+    out.push_back(4); // channels
+    out.push_back(0); // sRGB with linear alpha
+
+    Pixel index[64] = {};
+    Pixel previous = { 0, 0, 0, 255 };
+    uint8_t run = 0;
+
+    for (size_t i = 0; i < pixelCount; i++) {
+        Pixel px;
+        std::memcpy(&px, rgba + i * 4, 4);
+
+        if (px == previous) {
+            run++;
+            if (run == 62 || i == pixelCount - 1) {
+                out.push_back(opRun | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+
+        if (run > 0) {
+            out.push_back(opRun | (run - 1));
+            run = 0;
+        }
+
+        const uint32_t slot = indexOf(px);
+        if (index[slot] == px) {
+            out.push_back(opIndex | static_cast<uint8_t>(slot));
+        }
+        else {
+            index[slot] = px;
+            if (px.a == previous.a) {
+                const int8_t dr = static_cast<int8_t>(px.r - previous.r);
+                const int8_t dg = static_cast<int8_t>(px.g - previous.g);
+                const int8_t db = static_cast<int8_t>(px.b - previous.b);
+                const int8_t drdg = static_cast<int8_t>(dr - dg);
+                const int8_t dbdg = static_cast<int8_t>(db - dg);
+
+                if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2) {
+                    out.push_back(opDiff | static_cast<uint8_t>((dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+                }
+                else if (drdg > -9 && drdg < 8 && dg > -33 && dg < 32 && dbdg > -9 && dbdg < 8) {
+                    out.push_back(opLuma | static_cast<uint8_t>(dg + 32));
+                    out.push_back(static_cast<uint8_t>((drdg + 8) << 4 | (dbdg + 8)));
+                }
+                else {
+                    out.insert(out.end(), { opRgb, px.r, px.g, px.b });
+                }
+            }
+            else {
+                out.insert(out.end(), { opRgba, px.r, px.g, px.b, px.a });
+            }
+        }
+        previous = px;
+    }
+
+    out.insert(out.end(), std::begin(endMarker), std::end(endMarker));
+}
+
+bool QoiCodec::decode(const uint8_t* data, size_t size, Image& image) {
+    if (size < headerSize + sizeof(endMarker) || std::memcmp(data, "qoif", 4) != 0 || data[12] != 4) {
+        return false;
+    }
+    image.width = read32(data + 4);
+    image.height = read32(data + 8);
+    const uint64_t pixelCount = static_cast<uint64_t>(image.width) * image.height;
+    if (image.width == 0 || image.height == 0 || pixelCount > maxPixels) {
+        return false;
+    }
+    image.pixels.resize(static_cast<size_t>(pixelCount) * 4);
+
+    Pixel index[64] = {};
+    Pixel px = { 0, 0, 0, 255 };
+    uint8_t* dst = image.pixels.data();
+    uint8_t* const dstEnd = dst + image.pixels.size();
+
+    // Every chunk is at most 5 bytes, the end marker is never read as pixel data
+    size_t p = headerSize;
+    const size_t chunksEnd = size - sizeof(endMarker);
+
+    while (dst < dstEnd) {
+        if (p >= chunksEnd) {
+            return false;
+        }
+        const uint8_t op = data[p++];
+
+        if (op == opRgb) {
+            if (p + 3 > chunksEnd) {
+                return false;
+            }
+            px.r = data[p];
+            px.g = data[p + 1];
+            px.b = data[p + 2];
+            p += 3;
+        }
+        else if (op == opRgba) {
+            if (p + 4 > chunksEnd) {
+                return false;
+            }
+            std::memcpy(&px, data + p, 4);
+            p += 4;
+        }
+        else {
+            switch (op & tagMask) {
+            case opIndex:
+                px = index[op];
+                break;
+            case opDiff:
+                px.r += ((op >> 4) & 0x03) - 2;
+                px.g += ((op >> 2) & 0x03) - 2;
+                px.b += (op & 0x03) - 2;
+                break;
+            case opLuma: {
+                if (p >= chunksEnd) {
+                    return false;
+                }
+                const uint8_t next = data[p++];
+                const int dg = (op & 0x3f) - 32;
+                px.r += dg - 8 + ((next >> 4) & 0x0f);
+                px.g += dg;
+                px.b += dg - 8 + (next & 0x0f);
+                break;
+            }
+            default: {
+                // Run of the previous pixel, clamped to the image
+                size_t run = (op & 0x3f) + 1;
+                const size_t remaining = static_cast<size_t>(dstEnd - dst) / 4;
+                run = run < remaining ? run : remaining;
+                for (size_t i = 0; i < run; i++, dst += 4) {
+                    std::memcpy(dst, &px, 4);
+                }
+                continue;
+            }
+            }
+        }
+
+        index[indexOf(px)] = px;
+        std::memcpy(dst, &px, 4);
+        dst += 4;
+    }
+    return true;
+}
@@ -0,0 +1,24 @@
+#ifndef QOICODEC_H
+#define QOICODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Lossless "Quite OK Image" codec, RGBA only
+// Decoding is a single pass with a 64 entry colour index, several times faster than inflating a PNG
+namespace QoiCodec {
+    struct Image {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> pixels; // RGBA, tightly packed
+    };
+
+    // Appends the encoded stream (header, chunks, end marker) to out
+    void encode(const uint8_t* rgba, uint32_t width, uint32_t height, std::vector<uint8_t>& out);
+
+    // Returns false on a truncated or malformed stream
+    bool decode(const uint8_t* data, size_t size, Image& image);
+}
+
+#endif
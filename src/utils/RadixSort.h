@@ -0,0 +1,46 @@
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stable LSD radix sort of 64-bit keys, one byte per pass
+// Only bytes [firstByte, 8) are sorted on, and a byte every key shares is skipped without a pass.
+// scratch is swapped with keys as passes run, keep both around to sort without allocating.
+inline void radixSortKeys(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch, int firstByte = 0) {
+    const size_t count = keys.size();
+    if (count < 2) {
+        return;
+    }
+    scratch.resize(count);
+
+    // Every byte's histogram in one read of the keys
+    size_t histograms[8][256] = {};
+    for (const uint64_t key : keys) {
+        for (int byte = firstByte; byte < 8; byte++) {
+            histograms[byte][(key >> (byte * 8)) & 0xff]++;
+        }
+    }
+
+    for (int byte = firstByte; byte < 8; byte++) {
+        size_t* histogram = histograms[byte];
+        const int shift = byte * 8;
+        if (histogram[(keys[0] >> shift) & 0xff] == count) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            const size_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+        for (const uint64_t key : keys) {
+            scratch[histogram[(key >> shift) & 0xff]++] = key;
+        }
+        keys.swap(scratch);
+    }
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef TELEMETRYLAYOUT_H
+#define TELEMETRYLAYOUT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// Shared-memory layout of the live telemetry file, written by the engine (core/Telemetry.cpp) and
+// read by tools/telemetry_view. The file is one Block: a header and a ring of per-frame samples.
+//
+// Seqlock: the writer makes sequence odd, writes, then makes it even again. A reader copies the block
+// and keeps the copy only if sequence was the same even number before and after. The writer never waits.
+namespace TelemetryLayout {
+    constexpr uint32_t magic = 0x4D544F4B; // "KOTM"
+    constexpr uint32_t version = 1;
+    constexpr uint32_t sampleCapacity = 512;
+
+    enum Phase : uint32_t { LOAD_SCENE, INPUT, UPDATE, RENDER, LATE_UPDATE, PHASE_COUNT };
+
+    // Header flags
+    constexpr uint32_t allocationsTracked = 1u << 0;
+
+    struct Sample {
+        int32_t frame;
+        float frameMs;
+        float phaseMs[PHASE_COUNT];
+        float presentMs;
+        int32_t actors;
+        int32_t queuedImages;
+        int32_t queuedText;
+        int32_t queuedPixels;
+        int32_t drawCalls;
+        int32_t luaHeapKb;
+        int32_t gcCycles;
+        // Zero unless the header has allocationsTracked
+        uint32_t allocations;
+        uint64_t allocatedBytes;
+    };
+
+    struct Block {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t sampleSize;
+        uint32_t capacity;
+        std::atomic<uint64_t> sequence;
+        uint32_t flags;
+        uint32_t reserved;
+        // Samples ever written, the newest is samples[(written - 1) % capacity]
+        uint64_t written;
+        // Wall clock of the last write in ms since the epoch, readers use it to tell a live engine from a stale file
+        uint64_t updatedMs;
+        Sample samples[sampleCapacity];
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "the seqlock counter is shared between processes");
+
+    inline void beginWrite(Block& block) {
+        block.sequence.store(block.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    inline void endWrite(Block& block) {
+        block.sequence.store(block.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // false when the writer was mid-update, try again
+    inline bool tryRead(const Block& block, Block& copy) {
+        const uint64_t before = block.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        std::memcpy(static_cast<void*>(&copy), static_cast<const void*>(&block), sizeof(Block));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return block.sequence.load(std::memory_order_relaxed) == before;
+    }
+}
+
+#endif
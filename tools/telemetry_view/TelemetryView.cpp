@@ -0,0 +1,209 @@
+// Live view of the engine's shared-memory telemetry, see src/utils/TelemetryLayout.h
+//
+//   telemetry_view [path] [--interval ms] [--width columns] [--once]
+//
+// Run the game with "telemetry": true in game.config, then start this in another terminal.
+// The file is only ever read, the engine never waits on this process.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/MappedFile.h"
+#include "utils/TelemetryLayout.h"
+
+namespace {
+    // The engine creates and sizes the file before it writes the header, a viewer started alongside it can get in between
+    constexpr auto headerWait = std::chrono::seconds(3);
+    constexpr auto headerRetryInterval = std::chrono::milliseconds(20);
+
+    struct Options {
+        std::string path;
+        int intervalMs = 250;
+        int width = 72;
+        bool once = false;
+    };
+
+    std::string defaultPath() {
+        std::error_code error;
+        const std::filesystem::path shared = "/dev/shm";
+        return ((std::filesystem::is_directory(shared, error) ? shared : std::filesystem::temp_directory_path(error)) / "ko_telemetry").string();
+    }
+
+    Options parseOptions(int argc, char* argv[]) {
+        Options options;
+        options.path = defaultPath();
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            if (argument == "--interval" && i + 1 < argc) {
+                options.intervalMs = std::max(std::atoi(argv[++i]), 10);
+            }
+            else if (argument == "--width" && i + 1 < argc) {
+                options.width = std::max(std::atoi(argv[++i]), 16);
+            }
+            else if (argument == "--once") {
+                options.once = true;
+            }
+            else {
+                options.path = argument;
+            }
+        }
+        return options;
+    }
+
+    // Oldest first, at most count of the newest samples
+    std::vector<TelemetryLayout::Sample> newestSamples(const TelemetryLayout::Block& block, size_t count) {
+        const size_t available = static_cast<size_t>(std::min<uint64_t>(block.written, TelemetryLayout::sampleCapacity));
+        count = std::min(count, available);
+        std::vector<TelemetryLayout::Sample> samples;
+        samples.reserve(count);
+        for (size_t i = count; i > 0; i--) {
+            samples.push_back(block.samples[(block.written - i) % TelemetryLayout::sampleCapacity]);
+        }
+        return samples;
+    }
+
+    // One column per sample, scaled to the largest value shown
+    template <typename Value>
+    std::string sparkline(const std::vector<TelemetryLayout::Sample>& samples, Value value) {
+        static const char* const levels[] = { " ", "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█" };
+        float highest = 0.0f;
+        for (const auto& sample : samples) {
+            highest = std::max(highest, static_cast<float>(value(sample)));
+        }
+        std::string line;
+        for (const auto& sample : samples) {
+            const float fraction = highest > 0.0f ? static_cast<float>(value(sample)) / highest : 0.0f;
+            line += levels[std::clamp(static_cast<int>(fraction * 8.0f + 0.5f), 0, 8)];
+        }
+        char scale[32];
+        std::snprintf(scale, sizeof(scale), " %.2f", highest);
+        return line + scale;
+    }
+
+    float percentile(std::vector<float> values, float percent) {
+        if (values.empty()) {
+            return 0.0f;
+        }
+        const size_t rank = static_cast<size_t>(std::clamp(percent / 100.0f * static_cast<float>(values.size()) + 0.999f, 1.0f, static_cast<float>(values.size())));
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(rank - 1), values.end());
+        return values[rank - 1];
+    }
+
+    void draw(const Options& options, const TelemetryLayout::Block& block) {
+        const auto samples = newestSamples(block, TelemetryLayout::sampleCapacity);
+        if (samples.empty()) {
+            std::printf("%s: no frames yet\n", options.path.c_str());
+            return;
+        }
+        const TelemetryLayout::Sample& last = samples.back();
+
+        std::vector<float> frameMs;
+        float totalMs = 0.0f;
+        int gcCycles = 0;
+        for (const auto& sample : samples) {
+            frameMs.push_back(sample.frameMs);
+            totalMs += sample.frameMs;
+            gcCycles += sample.gcCycles;
+        }
+        const float seconds = totalMs / 1000.0f;
+
+        const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        const double age = (static_cast<double>(now) - static_cast<double>(block.updatedMs)) / 1000.0;
+
+        std::printf("%s  frame %d  %s", options.path.c_str(), last.frame, age < 1.0 ? "live" : "stale");
+        if (age >= 1.0) {
+            std::printf(" %.1fs", age);
+        }
+        std::printf("\n\nframe %.2f ms  fps %.1f  p50 %.2f  p99 %.2f  max %.2f ms  (last %zu frames)\n",
+            last.frameMs, seconds > 0.0f ? samples.size() / seconds : 0.0f,
+            percentile(frameMs, 50), percentile(frameMs, 99), percentile(frameMs, 100), samples.size());
+        std::printf("load %.2f  input %.2f  update %.2f  render %.2f  late %.2f  present %.2f ms\n",
+            last.phaseMs[TelemetryLayout::LOAD_SCENE], last.phaseMs[TelemetryLayout::INPUT], last.phaseMs[TelemetryLayout::UPDATE],
+            last.phaseMs[TelemetryLayout::RENDER], last.phaseMs[TelemetryLayout::LATE_UPDATE], last.presentMs);
+        std::printf("actors %d  images %d  text %d  pixels %d  draw calls %d\n",
+            last.actors, last.queuedImages, last.queuedText, last.queuedPixels, last.drawCalls);
+        std::printf("lua heap %d kb  gc cycles/s %.1f", last.luaHeapKb, seconds > 0.0f ? gcCycles / seconds : 0.0f);
+        if (block.flags & TelemetryLayout::allocationsTracked) {
+            std::printf("  allocations/frame %u (%.1f kb)", last.allocations, last.allocatedBytes / 1024.0);
+        }
+        std::printf("\n\n");
+
+        const auto shown = newestSamples(block, static_cast<size_t>(options.width));
+        std::printf("frame ms   %s\n", sparkline(shown, [](const auto& s) { return s.frameMs; }).c_str());
+        std::printf("update ms  %s\n", sparkline(shown, [](const auto& s) { return s.phaseMs[TelemetryLayout::UPDATE]; }).c_str());
+        std::printf("render ms  %s\n", sparkline(shown, [](const auto& s) { return s.phaseMs[TelemetryLayout::RENDER]; }).c_str());
+        std::printf("lua kb     %s\n", sparkline(shown, [](const auto& s) { return s.luaHeapKb; }).c_str());
+        if (block.flags & TelemetryLayout::allocationsTracked) {
+            std::printf("allocs     %s\n", sparkline(shown, [](const auto& s) { return s.allocations; }).c_str());
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const Options options = parseOptions(argc, argv);
+
+    MappedFile file;
+    // Set while the mapping is there but its header isn't valid yet
+    std::chrono::steady_clock::time_point headerDeadline = {};
+    bool waitingForHeader = false;
+    while (true) {
+        if (!file.isOpen() && (!file.openReadOnly(options.path) || file.size() < sizeof(TelemetryLayout::Block))) {
+            file.close();
+            if (options.once) {
+                std::fprintf(stderr, "%s: no telemetry, run the game with \"telemetry\": true\n", options.path.c_str());
+                return 1;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.intervalMs));
+            continue;
+        }
+
+        const auto& shared = *reinterpret_cast<const TelemetryLayout::Block*>(file.data());
+        if (shared.magic != TelemetryLayout::magic || shared.version != TelemetryLayout::version || shared.sampleSize != sizeof(TelemetryLayout::Sample)) {
+            const auto now = std::chrono::steady_clock::now();
+            if (!waitingForHeader) {
+                waitingForHeader = true;
+                headerDeadline = now + headerWait;
+            }
+            if (now >= headerDeadline) {
+                std::fprintf(stderr, "%s: not a version %u telemetry file\n", options.path.c_str(), TelemetryLayout::version);
+                return 1;
+            }
+            // Mapped again on the next try in case the engine recreates the file
+            file.close();
+            std::this_thread::sleep_for(headerRetryInterval);
+            continue;
+        }
+        waitingForHeader = false;
+
+        // A few retries cover a frame being written mid copy
+        static TelemetryLayout::Block copy;
+        bool consistent = false;
+        for (int attempt = 0; attempt < 100 && !consistent; attempt++) {
+            consistent = TelemetryLayout::tryRead(shared, copy);
+            if (!consistent) {
+                std::this_thread::yield();
+            }
+        }
+        if (consistent) {
+            if (!options.once) {
+                std::printf("\033[H\033[2J");
+            }
+            draw(options, copy);
+            std::fflush(stdout);
+        }
+        if (options.once) {
+            if (!consistent) {
+                std::fprintf(stderr, "%s: the engine kept writing, try again\n", options.path.c_str());
+            }
+            return consistent ? 0 : 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.intervalMs));
+    }
+}